@@ -0,0 +1,119 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file accum.h
+ * @brief File containing the declaration of the streaming statistics accumulator.
+ *
+ * An accumulator keeps the count, minimum, maximum, mean, variance and histogram of every sample
+ * pushed into it in constant memory, so statistics can be computed over streams that never fit in
+ * RAM. Samples can be pushed one at a time (Welford update) or in batches, and two accumulators can
+ * be merged (Chan et al. update), so partial streams can be combined in any order.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __ACCUM_H__
+#define __ACCUM_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stats.h"
+
+/**
+ * @brief Running state of a stream of unsigned char samples.
+ *
+ * Counters are 64-bit so a stream can outgrow the address space of the platform.
+ */
+typedef struct
+{
+  uint64_t count;                               /* Number of samples pushed */
+  unsigned char minimum;                        /* Smallest sample, 255 while empty */
+  unsigned char maximum;                        /* Largest sample, 0 while empty */
+  double mean;                                  /* Running mean */
+  double m2;                                    /* Sum of squared differences from the mean */
+  uint64_t histogram[STATS_HISTOGRAM_BINS];     /* Occurrences of every value */
+} stats_accum_t;
+
+/**
+ * @brief Statistics of the samples pushed into an accumulator.
+ */
+typedef struct
+{
+  uint64_t count;             /* Number of samples */
+  unsigned char minimum;      /* Smallest sample, 0 if empty */
+  unsigned char maximum;      /* Largest sample, 0 if empty */
+  unsigned char median;       /* Median as returned by find_median, 0 if empty */
+  double mean;                /* Mean, 0 if empty */
+  double variance;            /* Population variance, 0 if empty */
+} stats_accum_result_t;
+
+/**
+ * @brief Function to reset an accumulator to the empty state.
+ *
+ * @param accum Pointer to the accumulator.
+ *
+ * @return void.
+ */
+void accum_init(stats_accum_t * accum);
+
+/**
+ * @brief Function to add one sample to an accumulator.
+ *
+ * This function updates the count, minimum, maximum and histogram, and the mean and variance with
+ * the Welford recurrence, in constant time.
+ *
+ * @param accum  Pointer to the accumulator.
+ * @param sample Sample to add.
+ *
+ * @return void.
+ */
+void accum_push(stats_accum_t * accum, unsigned char sample);
+
+/**
+ * @brief Function to add an array of samples to an accumulator.
+ *
+ * This function takes in three input arguments: a pointer to the accumulator, a pointer to an array
+ * of unsigned char values and the size of the array. The array is reduced to a histogram by
+ * select_histogram, the same reduction compute_summary uses, and the batch statistics are derived
+ * from the histogram and merged into the accumulator.
+ *
+ * @param accum         Pointer to the accumulator.
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ *
+ * @return void.
+ */
+void accum_push_batch(stats_accum_t * accum, const unsigned char * array_pointer, size_t array_size);
+
+/**
+ * @brief Function to merge an accumulator into another one.
+ *
+ * After the call dst describes the samples of both accumulators, as if all of them had been pushed
+ * into dst. The operation is associative and commutative up to floating point rounding.
+ *
+ * @param dst Pointer to the accumulator to update.
+ * @param src Pointer to the accumulator to merge, not modified.
+ *
+ * @return void.
+ */
+void accum_merge(stats_accum_t * dst, const stats_accum_t * src);
+
+/**
+ * @brief Function to read the statistics of an accumulator.
+ *
+ * @param accum Pointer to the accumulator.
+ *
+ * @return Statistics of every sample pushed so far.
+ */
+stats_accum_result_t accum_result(const stats_accum_t * accum);
+
+#endif /* __ACCUM_H__ */
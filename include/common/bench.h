@@ -0,0 +1,44 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file bench.h
+ * @brief File containing the declaration of the throughput benchmarks.
+ *
+ * The benchmarks are built with COURSE=BENCH and only report results on the HOST platform, where a
+ * monotonic clock is available.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+/* Size of the benchmark buffer in bytes */
+#define BENCH_SIZE_B  (64u * 1024u * 1024u)
+
+/* Number of elements of the sort benchmarks */
+#define BENCH_SORT_SIZE  (1024u * 1024u)
+
+/* Number of timed runs, the fastest one is reported */
+#define BENCH_REPEAT  (5)
+
+/**
+ * @brief function to run every throughput benchmark
+ *
+ * This function fills a BENCH_SIZE_B buffer with pseudo random samples and
+ * prints the throughput of every kernel table supported by the running CPU.
+ *
+ * @return void
+ */
+void bench(void);
+
+#endif /* __BENCH_H__ */
@@ -27,11 +27,46 @@
 #define MEM_SET_SIZE_B  (32)
 #define MEM_SET_SIZE_W  (8)
 #define MEM_ZERO_LENGTH (16)
+#define STATS_SET_SIZE_W (250)
+#define STATS_SET_SIZE_B (1000)
+#define STATS_SMALL_SIZE (37)
+#define PARALLEL_SET_SIZE_B (5u * 256u * 1024u + 4099u)
+#define SORT_SET_SIZE_W (1027)
+#define PARALLEL_SORT_SIZE_W (9u * 4096u + 1234u)
+#define TYPED_SET_SIZE (1000)
+#define SKETCH_TEST_SIZE (200000u)
+#define SKETCH_TEST_ERROR (0.03)
+#define PERCENTILE_COUNT (10)
+#define MOMENTS_SET_SIZE (100000)
+#define MOMENTS_SKEWED_SIZE (10)
+#define MOMENTS_TOLERANCE (1e-6)
+#define DATASET_SET_SIZE_B (4096)
+#define TOP_K_COUNT (10)
+#define ROBUST_OUTLIER_COUNT (7)
+#define WEIGHTED_MAX_COUNT (4)
+#define POOL_TEST_BLOCKS (64)
+#define MOVE_TEST_BUFFER (256)
+#define MOVE_TEST_MAX_LENGTH (160)
+#define MOVE_TEST_MAX_SHIFT (19)
+#define COPY_TEST_BUFFER (384)
+#define COPY_TEST_MAX_LENGTH (320)
+#define COPY_TEST_MAX_OFFSET (32)
+#define COPY_TEST_STREAM_THRESHOLD (64)
+
+/* Large input mode, enabled with OPTION=LARGE_INPUT. Default is just above 4 GiB */
+#ifndef LARGE_INPUT_SIZE_B
+#define LARGE_INPUT_SIZE_B  ((size_t)0x100001000ULL)
+#endif
 
 #define TEST_MEMMOVE_LENGTH (16)
 #define TEST_ERROR          (1)
 #define TEST_NO_ERROR       (0)
-#define TESTCOUNT           (8)
+#ifdef LARGE_INPUT
+#define LARGE_TESTCOUNT     (1)
+#else
+#define LARGE_TESTCOUNT     (0)
+#endif
+#define TESTCOUNT           (31 + LARGE_TESTCOUNT)
 
 /**
  * @brief function to run course1 materials
@@ -129,5 +164,285 @@ int8_t test_memset();
  */
 int8_t test_reverse();
 
+/**
+ * @brief function to test the order statistic selection
+ * 
+ * This function calls find_kth and find_median on short and long pseudo random
+ * data sets and compares every rank against a brute force count.
+ *
+ * @return void
+ */
+int8_t test_kth();
+
+/**
+ * @brief function to test the single pass summary
+ * 
+ * This function calls compute_summary on a pseudo random data set and checks
+ * the histogram, minimum, maximum, sum, mean and median against direct loops
+ * and find_median.
+ *
+ * @return void
+ */
+int8_t test_summary();
+
+/**
+ * @brief function to test the reduction kernels
+ * 
+ * This function runs every kernel table supported by the running CPU, and
+ * the emulated Cortex-M4 DSP table, over many lengths and alignments of a
+ * small pseudo random data set and compares the results against the scalar
+ * reference kernels.
+ *
+ * @return void
+ */
+int8_t test_kernels();
+
+/**
+ * @brief function to test the streaming accumulator
+ * 
+ * This function feeds a pseudo random data set to two accumulators, one
+ * sample at a time and in batches, merges them and compares the result with
+ * compute_summary and a two pass variance.
+ *
+ * @return void
+ */
+int8_t test_accum();
+
+/**
+ * @brief function to test the mergeable partial summaries
+ * 
+ * This function summarizes three uneven shards of a data set, merges them in
+ * two different orders, one of them through a serialization round trip, and
+ * compares both results with the summary of the whole data set. A corrupted
+ * buffer must be rejected.
+ *
+ * @return void
+ */
+int8_t test_summary_merge();
+
+/**
+ * @brief function to test the multithreaded reduction engine
+ * 
+ * This function forces the parallel path with a zero size threshold and
+ * several thread counts, with and without the histogram, then the serial
+ * path, and compares every reduction with the scalar reference kernels.
+ *
+ * @return void
+ */
+int8_t test_parallel();
+
+/**
+ * @brief function to test the sort engine
+ * 
+ * This function checks that sort_array returns a descending permutation of
+ * its input, that the radix sorts agree with the introsort on random 16 and
+ * 32-bit data in both orders, and that the introsort handles sorted, reversed
+ * and constant inputs.
+ *
+ * @return void
+ */
+int8_t test_sort();
+
+/**
+ * @brief function to test the parallel sorts
+ * 
+ * This function runs sort_array_parallel and sort_generic_parallel with 1 to
+ * 8 threads and checks that they produce the same descending order as the
+ * single threaded sorts, including on keys with many duplicates.
+ *
+ * @return void
+ */
+int8_t test_sort_parallel();
+
+/**
+ * @brief function to test the typed statistics kernels
+ * 
+ * This function runs stats_compute on 12-bit ADC samples, signed 32-bit
+ * values, floats and doubles and checks the results against reference
+ * loops, checks that stats_mode finds a planted run and the smallest sample
+ * on ties, and checks that the byte kernel agrees with find_minimum,
+ * find_maximum, find_mean and the mode of compute_summary.
+ *
+ * @return void
+ */
+int8_t test_typed();
+
+/**
+ * @brief function to test the sliding window statistics
+ * 
+ * This function pushes random samples and monotonic ramps through windows
+ * of several widths and checks after every sample that the window minimum,
+ * maximum, mean and median match the stats.h functions over the same
+ * samples, and that widths of 0 or too large to allocate are refused.
+ *
+ * @return void
+ */
+int8_t test_window();
+
+/**
+ * @brief function to test the quantile sketch
+ * 
+ * This function streams a permutation of 0..N-1 into two sketches, merges
+ * them and checks that the p1, p50, p95 and p99 quantiles and the cumulative
+ * distribution are within SKETCH_TEST_ERROR of the exact ranks, and that
+ * NaN samples are ignored.
+ *
+ * @return void
+ */
+int8_t test_sketch();
+
+/**
+ * @brief function to test the batch percentile queries
+ * 
+ * This function asks find_percentiles for ten quantiles at once, unsorted,
+ * repeated and out of range, on 8-bit, 16-bit, signed 32-bit and double
+ * arrays, and checks every answer against a full sort or find_kth.
+ *
+ * @return void
+ */
+int8_t test_percentiles();
+
+/**
+ * @brief function to test the higher moments, mode and range
+ * 
+ * This function checks the moments of compute_summary against a two pass
+ * reference, the moments of the typed kernels on a large offset that defeats
+ * a naive sum of squares, and a small set with known skewness and kurtosis.
+ *
+ * @return void
+ */
+int8_t test_moments();
+
+/**
+ * @brief function to test the cached dataset handle
+ * 
+ * This function attaches two datasets, writes to them with the memory.h
+ * setters and with announced direct writes, and checks every cached summary
+ * against a fresh compute_summary of the same array.
+ *
+ * @return void
+ */
+int8_t test_dataset();
+
+/**
+ * @brief function to test the top-k and bottom-k selection
+ * 
+ * This function checks find_top_k and find_bottom_k on long and short
+ * arrays against the head and tail of sort_array, and sort_partial on both
+ * its heap and its select engines against a full sort.
+ *
+ * @return void
+ */
+int8_t test_top_k();
+
+/**
+ * @brief function to test the robust statistics
+ * 
+ * This function plants outliers in a narrow random set and checks the
+ * quartiles, median absolute deviation and outlier bitmap against
+ * find_percentiles, find_median and the planted positions.
+ *
+ * @return void
+ */
+int8_t test_robust();
+
+/**
+ * @brief function to test the two-array kernels
+ * 
+ * This function checks the covariance, correlation and regression line of
+ * exact linear relations, of random bytes against a two pass reference and
+ * of large offset doubles, plus the constant and empty cases.
+ *
+ * @return void
+ */
+int8_t test_pair();
+
+/**
+ * @brief function to test the weighted statistics
+ * 
+ * This function checks the weighted statistics of an array with integer
+ * counts against the statistics of the expanded array, equal real weights
+ * against the unweighted statistics, and a small hand computed case with
+ * ignored negative and NaN weights.
+ *
+ * @return void
+ */
+int8_t test_weighted();
+
+/**
+ * @brief function to test the scratch arena variants
+ * 
+ * This function runs find_median_scratch, find_kth_scratch,
+ * find_percentiles_scratch, stats_mode_scratch, find_top_k_scratch and
+ * find_bottom_k_scratch from one arena, with and without permission to
+ * reorder the input, and the robust and weighted _scratch variants, and
+ * checks them against the allocating
+ * functions, the input and the arena after every call, and an arena that is
+ * too small.
+ *
+ * @return void
+ */
+int8_t test_scratch();
+
+/**
+ * @brief function to test the pool behind reserve_words
+ * 
+ * This function checks that freed blocks are reused by the next request of
+ * their class, that every block is aligned and that many live blocks of
+ * mixed classes, including blocks too large for the pool, do not overlap.
+ *
+ * @return void
+ */
+int8_t test_pool();
+
+/**
+ * @brief function to test my_memmove on every overlap
+ * 
+ * This function moves blocks of every length up to MOVE_TEST_MAX_LENGTH,
+ * from every alignment, by every shift up to MOVE_TEST_MAX_SHIFT in both
+ * directions, and checks the whole buffer against a reference move done
+ * through a separate copy.
+ *
+ * @return void
+ */
+int8_t test_memmove_overlap();
+
+/**
+ * @brief function to test every copy engine of my_memcopy
+ * 
+ * This function copies blocks of lengths up to COPY_TEST_MAX_LENGTH from
+ * every source and destination offset below COPY_TEST_MAX_OFFSET with every
+ * engine of memcopy_available and with my_memcopy itself, and checks the
+ * whole destination buffer against my_memcopy_reference, so the bytes around
+ * the block must be left untouched as well.
+ *
+ * @return void
+ */
+int8_t test_memcopy_engines();
+
+/**
+ * @brief function to test the streaming mode of my_memcopy and my_memset
+ * 
+ * This function checks that the default streaming threshold is the size of
+ * the last level cache, lowers it to COPY_TEST_STREAM_THRESHOLD so blocks
+ * on both sides of it are copied and filled from every offset, checks the
+ * whole buffers against byte loops and restores the default.
+ *
+ * @return void
+ */
+int8_t test_memcopy_stream();
+
+/**
+ * @brief function to test the statistics functions on a multi-gigabyte buffer
+ * 
+ * This function is only run when built with OPTION=LARGE_INPUT. It fills a
+ * buffer of LARGE_INPUT_SIZE_B bytes, larger than any 32-bit index or sum can
+ * describe, with a repeating 0..255 ramp and checks every stats.h function
+ * against the known closed form results.
+ *
+ * @return void
+ */
+int8_t test_large_input();
+
 #endif /* __COURSE1_H__ */
 
@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file dataset.h
+ * @brief File containing the declaration of the cached dataset handle.
+ *
+ * A dataset caches the summary of an array of unsigned char values between queries. Every byte
+ * written through the memory.h setters updates the cached histogram before it is written, so a
+ * query after a few set_value or clear_value calls costs O(changed bytes + 256) instead of a full
+ * rescan. Bytes written any other way, for example with my_memcopy, are announced beforehand with
+ * dataset_invalidate: their old values are taken out of the histogram and the dirty range is
+ * counted again by the next query.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __DATASET_H__
+#define __DATASET_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stats.h"
+
+/**
+ * @brief Cached summary of an array, attached with dataset_attach.
+ *
+ * The histogram of the summary always counts every byte outside the dirty range. The bytes inside
+ * the dirty range are counted again, and the other fields derived, by the next dataset_summary.
+ */
+typedef struct stats_dataset
+{
+  unsigned char * data;                         /* Array described by the summary */
+  size_t length;                                /* Size of the array */
+  size_t dirty_begin;                           /* First byte of the dirty range */
+  size_t dirty_end;                             /* One past the last byte of the dirty range */
+  uint8_t stale;                                /* Set when the derived fields are out of date */
+  struct stats_dataset * next;                  /* Next attached dataset */
+  stats_summary_t summary;                      /* Cached summary */
+} stats_dataset_t;
+
+/**
+ * @brief Function to attach a dataset to an array.
+ *
+ * The array is scanned once and the dataset starts tracking the writes of the memory.h setters.
+ * Several datasets may be attached at the same time, but not twice the same one.
+ *
+ * @param dataset Pointer to the dataset.
+ * @param data    Pointer to the array of unsigned char values.
+ * @param length  Size of the array.
+ *
+ * @return void.
+ */
+void dataset_attach(stats_dataset_t * dataset, unsigned char * data, size_t length);
+
+/**
+ * @brief Function to stop tracking the writes to the array of a dataset.
+ *
+ * @param dataset Pointer to an attached dataset.
+ *
+ * @return void.
+ */
+void dataset_detach(stats_dataset_t * dataset);
+
+/**
+ * @brief Function to announce a write that does not go through the memory.h setters.
+ *
+ * It must be called before the bytes are written. The range is clamped to the array and merged
+ * with the current dirty range, only the bytes that were not dirty yet are visited.
+ *
+ * @param dataset Pointer to an attached dataset.
+ * @param begin   First byte about to be written.
+ * @param end     One past the last byte about to be written.
+ *
+ * @return void.
+ */
+void dataset_invalidate(stats_dataset_t * dataset, size_t begin, size_t end);
+
+/**
+ * @brief Function to get the up to date summary of a dataset.
+ *
+ * Only the dirty range is read again, and the derived fields are recomputed from the histogram
+ * only if a byte changed since the last query.
+ *
+ * @param dataset Pointer to an attached dataset.
+ *
+ * @return Pointer to the cached summary, valid until the next write to the array.
+ */
+const stats_summary_t * dataset_summary(stats_dataset_t * dataset);
+
+/**
+ * @brief Function to print the statistics of a dataset like print_statistics.
+ *
+ * @param dataset Pointer to an attached dataset.
+ *
+ * @return void.
+ */
+void dataset_print_statistics(stats_dataset_t * dataset);
+
+#endif /* __DATASET_H__ */
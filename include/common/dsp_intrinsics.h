@@ -0,0 +1,124 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file dsp_intrinsics.h
+ * @brief Cortex-M4 packed byte intrinsics, native on MSP432 and emulated in C everywhere else.
+ *
+ * On the MSP432 platform the intrinsics come from CMSIS (core_cmSimd.h) and compile to single DSP
+ * instructions. On every other platform this header provides C functions with the same names and
+ * the same results, including the APSR.GE flags set by __UADD8/__USUB8 and consumed by __SEL, so the
+ * packed kernels can be tested and benchmarked on the host. The emulated GE flags live in a static
+ * variable of the including file, so the emulation is not reentrant.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __DSP_INTRINSICS_H__
+#define __DSP_INTRINSICS_H__
+
+#include <stdint.h>
+#include "platform.h"
+
+#if !defined (MSP432)
+#define DSP_EMULATED
+
+/* Emulated APSR.GE flags, bit i belongs to byte lane i */
+static uint32_t dsp_ge_flags;
+
+/**
+ * @brief Emulation of UADD8: lane-wise byte addition, GE set where the addition carries out.
+ */
+static inline uint32_t __UADD8(uint32_t op1, uint32_t op2)
+{
+  uint32_t result = 0;
+  uint32_t lane_sum;
+  uint8_t lane;
+
+  dsp_ge_flags = 0;
+  for(lane = 0; lane < 4; ++lane)
+  {
+    lane_sum = ((op1 >> (8 * lane)) & 0xFF) + ((op2 >> (8 * lane)) & 0xFF);
+    dsp_ge_flags |= (lane_sum > 0xFF) ? (1u << lane) : 0;
+    result |= (lane_sum & 0xFF) << (8 * lane);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Emulation of USUB8: lane-wise byte subtraction, GE set where op1 >= op2.
+ */
+static inline uint32_t __USUB8(uint32_t op1, uint32_t op2)
+{
+  uint32_t result = 0;
+  uint32_t lane1;
+  uint32_t lane2;
+  uint8_t lane;
+
+  dsp_ge_flags = 0;
+  for(lane = 0; lane < 4; ++lane)
+  {
+    lane1 = (op1 >> (8 * lane)) & 0xFF;
+    lane2 = (op2 >> (8 * lane)) & 0xFF;
+    dsp_ge_flags |= (lane1 >= lane2) ? (1u << lane) : 0;
+    result |= ((lane1 - lane2) & 0xFF) << (8 * lane);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Emulation of SEL: byte lane i is taken from op1 when GE[i] is set and from op2 otherwise.
+ */
+static inline uint32_t __SEL(uint32_t op1, uint32_t op2)
+{
+  uint32_t result = 0;
+  uint8_t lane;
+
+  for(lane = 0; lane < 4; ++lane)
+  {
+    result |= (((dsp_ge_flags >> lane) & 1u) ? op1 : op2) & (0xFFu << (8 * lane));
+  }
+
+  return result;
+}
+
+/**
+ * @brief Emulation of USAD8: sum of the absolute differences of the four byte lanes.
+ */
+static inline uint32_t __USAD8(uint32_t op1, uint32_t op2)
+{
+  uint32_t result = 0;
+  uint32_t lane1;
+  uint32_t lane2;
+  uint8_t lane;
+
+  for(lane = 0; lane < 4; ++lane)
+  {
+    lane1 = (op1 >> (8 * lane)) & 0xFF;
+    lane2 = (op2 >> (8 * lane)) & 0xFF;
+    result += lane1 > lane2 ? lane1 - lane2 : lane2 - lane1;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Emulation of USADA8: USAD8 of op1 and op2 accumulated into op3.
+ */
+static inline uint32_t __USADA8(uint32_t op1, uint32_t op2, uint32_t op3)
+{
+  return __USAD8(op1, op2) + op3;
+}
+#endif /* !MSP432 */
+
+#endif /* __DSP_INTRINSICS_H__ */
@@ -0,0 +1,102 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file kernels.h
+ * @brief File containing the declaration of the reduction kernels used by the statistics functions.
+ *
+ * A kernel table groups one implementation of every byte reduction (minimum, maximum, sum and
+ * histogram). The scalar table is the reference implementation and is available on every platform.
+ * The DSP table uses the Cortex-M4 packed byte instructions; it is the table used on MSP432 and runs
+ * on top of a C emulation of the instructions everywhere else, for testing. On x86 hosts SSE2, AVX2
+ * and AVX-512BW tables are also built and the best one supported by the CPU is selected once, the
+ * first time kernels_get is called.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __KERNELS_H__
+#define __KERNELS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined (HOST) && (defined (__x86_64__) || defined (__i386__))
+#define KERNELS_X86
+#endif
+
+/* Maximum number of kernel tables that can be available at the same time */
+#define KERNELS_MAX_TABLES (8)
+
+/**
+ * @brief Table of byte reduction kernels.
+ *
+ * Every implementation returns exactly the same results as the scalar reference: the minimum of an
+ * empty array is 255, its maximum and sum are 0. The histogram kernel clears the 256 counters it is
+ * given before counting.
+ */
+typedef struct
+{
+  const char * name;                                          /* Instruction set name */
+  uint8_t (*minimum)(const uint8_t * src, size_t length);     /* Smallest element */
+  uint8_t (*maximum)(const uint8_t * src, size_t length);     /* Largest element */
+  uint64_t (*sum)(const uint8_t * src, size_t length);        /* Sum of all elements */
+  void (*histogram)(const uint8_t * src, size_t length, size_t * histogram); /* Occurrences of every value */
+} stats_kernels_t;
+
+/* Scalar reference kernels */
+extern const stats_kernels_t kernels_scalar;
+
+/* Cortex-M4 packed byte kernels, emulated when not built for MSP432 */
+extern const stats_kernels_t kernels_dsp;
+
+#ifdef KERNELS_X86
+/* x86 vector kernels, only call them when kernels_supported says so */
+extern const stats_kernels_t kernels_sse2;
+extern const stats_kernels_t kernels_avx2;
+extern const stats_kernels_t kernels_avx512bw;
+#endif
+
+/**
+ * @brief Function to get the fastest kernel table supported by the running CPU.
+ *
+ * The table is chosen the first time this function is called, later calls return the same table.
+ * MSP432 always uses the DSP table, x86 hosts the widest vector table reported by CPUID and any other
+ * host the scalar table.
+ *
+ * @return Pointer to the selected kernel table.
+ */
+const stats_kernels_t * kernels_get(void);
+
+/**
+ * @brief Function to check whether the running CPU can execute a kernel table.
+ *
+ * @param kernels Pointer to the kernel table.
+ *
+ * @return 1 if the table can be used, 0 otherwise.
+ */
+int8_t kernels_supported(const stats_kernels_t * kernels);
+
+/**
+ * @brief Function to list the kernel tables supported by the running CPU.
+ *
+ * This function fills the provided list with every kernel table built for this platform that the
+ * running CPU can execute, starting with the scalar reference. Emulated tables are listed as well. It
+ * is meant for tests and benchmarks.
+ *
+ * @param list     Pointer to an array of kernel table pointers to fill.
+ * @param max_size Number of entries of the list.
+ *
+ * @return Number of entries written.
+ */
+size_t kernels_available(const stats_kernels_t ** list, size_t max_size);
+
+#endif /* __KERNELS_H__ */
@@ -0,0 +1,200 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file memcopy.h
+ * @brief File containing the declaration of the block copy engines used by my_memcopy.
+ *
+ * An engine copies a block that does not overlap its destination. The byte engine is the reference
+ * loop and is available on every platform. The word engine copies bytes up to the first aligned
+ * destination word, then four words per iteration, then the tail; my_memmove uses it for the
+ * forward copies of overlapping blocks. The multiple load/store engine moves four words with one LDM
+ * and one STM on MSP432 and runs on top of a C version of the same burst everywhere else, for testing.
+ * On x86 hosts SSE2 and AVX engines are also built and the widest one supported by the CPU is
+ * selected once, the first time memcopy_get is called.
+ *
+ * Blocks of at least the streaming threshold are copied and filled with non-temporal stores, which
+ * write around the caches instead of evicting the data the statistics kernels read next. By default
+ * the threshold is the size of the last level cache, read once from the host; platforms without a
+ * detected cache never stream. Without non-temporal stores (anything but x86) the streaming functions
+ * use the regular loops.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __MEMCOPY_H__
+#define __MEMCOPY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kernels.h"
+
+/* Maximum number of copy engines that can be available at the same time */
+#define MEMCOPY_MAX_ENGINES (8)
+
+/* Last level cache assumed on a host that does not report one */
+#define MEMCOPY_DEFAULT_CACHE_B (8u * 1024u * 1024u)
+
+/**
+ * @brief Block copy engine.
+ *
+ * The copy function does not check its pointers and does not handle overlap of the source and the
+ * destination. Every engine leaves exactly the same bytes in the destination as the byte engine.
+ */
+typedef struct
+{
+  const char * name;                                              /* Instruction set name */
+  void (*copy)(const uint8_t * src, uint8_t * dst, size_t length); /* Copy length bytes */
+} memcopy_engine_t;
+
+/* Reference byte loop */
+extern const memcopy_engine_t memcopy_bytes;
+
+/* Aligned word loop */
+extern const memcopy_engine_t memcopy_words;
+
+/* Cortex-M4 multiple load/store bursts, emulated when not built for MSP432 */
+extern const memcopy_engine_t memcopy_ldm;
+
+#ifdef KERNELS_X86
+/* x86 vector engines, only call them when memcopy_supported says so */
+extern const memcopy_engine_t memcopy_sse2;
+extern const memcopy_engine_t memcopy_avx;
+#endif
+
+/**
+ * @brief Function to copy a block with the word engine, from its first byte to its last.
+ *
+ * Four words are read before any of them is written, so the destination may overlap the source as
+ * long as it does not start inside it.
+ *
+ * @param src    Pointer to the source block.
+ * @param dst    Pointer to the destination block.
+ * @param length Number of bytes to copy.
+ *
+ * @return void.
+ */
+void memcopy_forward(const uint8_t * src, uint8_t * dst, size_t length);
+
+/**
+ * @brief Function to copy a block from its last byte to its first.
+ *
+ * The destination may overlap the source as long as it does not end inside it. Every iteration reads a
+ * whole block before writing it, four words, or four vectors of the SSE2 or AVX width when one of those
+ * is the engine of memcopy_get.
+ *
+ * @param src    Pointer to the source block.
+ * @param dst    Pointer to the destination block.
+ * @param length Number of bytes to copy.
+ *
+ * @return void.
+ */
+void memcopy_backward(const uint8_t * src, uint8_t * dst, size_t length);
+
+/**
+ * @brief Function to fill a block with one byte value, a word at a time.
+ *
+ * @param dst    Pointer to the block.
+ * @param length Number of bytes to fill.
+ * @param value  Value written to every byte.
+ *
+ * @return void.
+ */
+void memcopy_fill(uint8_t * dst, size_t length, uint8_t value);
+
+/**
+ * @brief Function to copy a block with non-temporal stores.
+ *
+ * The destination is written around the caches, so the data they hold survives the copy. The stores
+ * are fenced before returning. The source and the destination must not overlap.
+ *
+ * @param src    Pointer to the source block.
+ * @param dst    Pointer to the destination block.
+ * @param length Number of bytes to copy.
+ *
+ * @return void.
+ */
+void memcopy_stream(const uint8_t * src, uint8_t * dst, size_t length);
+
+/**
+ * @brief Function to fill a block with one byte value with non-temporal stores.
+ *
+ * @param dst    Pointer to the block.
+ * @param length Number of bytes to fill.
+ * @param value  Value written to every byte.
+ *
+ * @return void.
+ */
+void memcopy_stream_fill(uint8_t * dst, size_t length, uint8_t value);
+
+/**
+ * @brief Function to get the size of the last level data cache.
+ *
+ * The size is read the first time this function is called, once even if several threads call it at
+ * the same time. Linux hosts read it from sysfs and fall back to MEMCOPY_DEFAULT_CACHE_B, other
+ * platforms report no cache.
+ *
+ * @return Size in bytes, 0 if the platform has no data cache.
+ */
+size_t memcopy_cache_size(void);
+
+/**
+ * @brief Function to set the size from which my_memcopy and my_memset use non-temporal stores.
+ *
+ * @param min_size Size in bytes, 0 to derive it from memcopy_cache_size, the default.
+ *
+ * @return void.
+ */
+void memcopy_set_stream_threshold(size_t min_size);
+
+/**
+ * @brief Function to get the size from which my_memcopy and my_memset use non-temporal stores.
+ *
+ * @return Size in bytes, SIZE_MAX if blocks are never streamed.
+ */
+size_t memcopy_get_stream_threshold(void);
+
+/**
+ * @brief Function to get the fastest copy engine supported by the running CPU.
+ *
+ * The engine is chosen the first time this function is called, once even if several threads call it
+ * at the same time, and later calls return the same engine.
+ * MSP432 always uses the multiple load/store engine, x86 hosts the widest vector engine reported by
+ * CPUID and any other host the word engine.
+ *
+ * @return Pointer to the selected engine.
+ */
+const memcopy_engine_t * memcopy_get(void);
+
+/**
+ * @brief Function to check whether the running CPU can execute a copy engine.
+ *
+ * @param engine Pointer to the engine.
+ *
+ * @return 1 if the engine can be used, 0 otherwise.
+ */
+int8_t memcopy_supported(const memcopy_engine_t * engine);
+
+/**
+ * @brief Function to list the copy engines supported by the running CPU.
+ *
+ * This function fills the provided list with every engine built for this platform that the running
+ * CPU can execute, starting with the byte reference. Emulated engines are listed as well. It is meant
+ * for tests and benchmarks.
+ *
+ * @param list     Pointer to an array of engine pointers to fill.
+ * @param max_size Number of entries of the list.
+ *
+ * @return Number of entries written.
+ */
+size_t memcopy_available(const memcopy_engine_t ** list, size_t max_size);
+
+#endif /* __MEMCOPY_H__ */
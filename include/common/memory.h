@@ -15,6 +15,13 @@
  * This header file provides an abstraction of reading and
  * writing to memory via function calls. 
  *
+ * reserve_words and free_words are served by a size-class pool: blocks of up to MEMORY_POOL_MAX_BLOCK
+ * bytes are carved from large chunks by a bump pointer and recycled through one free list per class,
+ * so short buffers never reach malloc once their class has been used. Larger blocks go to malloc.
+ * Built with OPTION=MEMORY_POOL_HEAP the chunks come from a single array placed in the NOLOAD .pool
+ * section of the linker script instead of malloc, and larger blocks are refused. On MSP432 the newlib
+ * heap starts after the pool and _sbrk stops it below the stack, so malloc never writes over the pool.
+ *
  * @author Alex Fosdick/Julian Hoyos
  * @date April 16 2023
  *
@@ -23,6 +30,57 @@
 #define __MEMORY_H__
 
 #include <stddef.h>
+#include <stdint.h>
+
+/* Payload of the smallest pool block in bytes, every class doubles the previous one */
+#define MEMORY_POOL_MIN_BLOCK (16u)
+
+/* Number of pool classes, blocks larger than the last one go to malloc */
+#define MEMORY_POOL_CLASSES (9u)
+
+/* Payload of the largest pool block in bytes */
+#define MEMORY_POOL_MAX_BLOCK (MEMORY_POOL_MIN_BLOCK << (MEMORY_POOL_CLASSES - 1))
+
+/* Size of the chunks the pool takes from malloc */
+#ifndef MEMORY_POOL_CHUNK
+#if defined (HOST)
+#define MEMORY_POOL_CHUNK (64u * 1024u)
+#else
+#define MEMORY_POOL_CHUNK (8u * 1024u)
+#endif
+#endif
+
+/* Size of the .pool array used instead of malloc with OPTION=MEMORY_POOL_HEAP */
+#ifndef MEMORY_HEAP_SIZE
+#define MEMORY_HEAP_SIZE (16u * 1024u)
+#endif
+
+/**
+ * @brief Write hook of the memory.h setters.
+ *
+ * Called by set_value, and so by clear_value, set_all and clear_all, before every byte is written,
+ * while the old value can still be read at ptr[index].
+ *
+ * @param context Pointer given to memory_set_write_hook.
+ * @param ptr     Pointer to the data array being written.
+ * @param index   Index of the byte being written.
+ * @param value   Value about to be written.
+ */
+typedef void (*memory_write_hook_t)(void * context, char * ptr, unsigned int index, char value);
+
+/**
+ * @brief Installs the write hook of the memory.h setters.
+ *
+ * There is a single hook, installing one replaces the previous one. The cached datasets of dataset.h
+ * install their own hook while any of them is attached.
+ *
+ * @param hook    Function called before every write, NULL to remove the hook.
+ * @param context Pointer passed back to the hook.
+ *
+ * @return void.
+ */
+void memory_set_write_hook(memory_write_hook_t hook, void * context);
+
 /**
  * @brief Sets a value of a data array 
  *
@@ -95,14 +153,17 @@ void clear_all(char * ptr, unsigned int size);
  * @brief Function to move a block of memory to another location.
  *
  * This function takes in three input arguments: a pointer to the source memory block, a pointer to the 
- * destination memory block and the length of the block to be moved. The function handle overlap of source 
- * and destination.
+ * destination memory block and the length of the block to be moved. Blocks that do not overlap are copied
+ * by the engine of memcopy_get. The function handle overlap of source and destination by copying
+ * backwards when the destination starts inside the source, with the vector loop of the selected engine
+ * on x86, and forwards a word at a time otherwise. The block is moved in place in a single pass and
+ * nothing is allocated.
  *
  * @param src    Pointer to the source memory block.
  * @param dst    Pointer to the destination memory block.
  * @param length Length of the memory block to be moved.
  *
- * @return A pointer to the destination memory block.
+ * @return A pointer to the destination memory block, NULL if src or dst is NULL.
  */
 uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length);
 
@@ -110,9 +171,10 @@ uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length);
  * @brief Function to copy a block of memory from a source to a destination location.
  *
  * This function takes in three input arguments: a pointer to the source memory location, a pointer to the 
- * destination memory location, and the size of the block of memory to be copied. The function iterates through 
- * the block of memory and copies each byte from the source to the destination location. If doesn't handle 
- * overlap of source and destination.
+ * destination memory location, and the size of the block of memory to be copied. The block is copied by the
+ * fastest engine of memcopy_get: bytes up to the first aligned destination address, a word or vector bulk
+ * loop, then the tail. Blocks of at least memcopy_get_stream_threshold bytes are written with non-temporal
+ * stores, so they do not evict the caches. It doesn't handle overlap of source and destination.
  *
  * @param src    Pointer to the source memory location.
  * @param dst    Pointer to the destination memory location.
@@ -122,13 +184,26 @@ uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length);
  */
 uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length);
 
+/**
+ * @brief Function to copy a block of memory one byte at a time.
+ *
+ * This is the reference loop of my_memcopy, kept to check the other engines against it.
+ *
+ * @param src    Pointer to the source memory location.
+ * @param dst    Pointer to the destination memory location.
+ * @param length Size of the block of memory to be copied.
+ *
+ * @return Pointer to the destination memory location if successful, otherwise NULL.
+ */
+uint8_t * my_memcopy_reference(uint8_t * src, uint8_t * dst, size_t length);
+
 /**
  * @brief Function to set a specified value in the memory.
  *
  * This function sets the specified value in the memory block pointed by the source pointer. 
  * The function takes in three input arguments: a pointer to the source memory block, the size of 
- * the memory block, and the value to be set. The function iterates through the memory block and 
- * sets each byte to the specified value.
+ * the memory block, and the value to be set. The block is filled a word at a time once it is aligned,
+ * with non-temporal stores from memcopy_get_stream_threshold bytes.
  *
  * @param src Pointer to the memory block to be set.
  * @param length Size of the memory block to be set.
@@ -173,13 +248,14 @@ uint8_t * my_reverse(uint8_t * src, size_t length);
 /**
  * @brief Function to allocate a memory block of specified size.
  *
- * This function allocates a memory block of the specified size in bytes. The function takes in 
- * one input argument: the size of the memory block to be allocated. The function allocates the 
- * memory block using the malloc function and returns a pointer to the first byte of the memory block.
+ * This function allocates a memory block of the specified size in words. The function takes in 
+ * one input argument: the number of 32-bit words to be allocated. Blocks of up to
+ * MEMORY_POOL_MAX_BLOCK bytes come from the pool of the smallest class that fits them, in O(1),
+ * larger blocks from malloc. Every block is aligned to 8 bytes.
  *
- * @param length Size of the memory block to be allocated.
+ * @param length Number of words to be allocated.
  *
- * @return A pointer to the first byte of the allocated memory block.
+ * @return A pointer to the first byte of the allocated memory block, NULL if it cannot be allocated.
  */
 int32_t * reserve_words(size_t length);
 
@@ -188,10 +264,10 @@ int32_t * reserve_words(size_t length);
  * @brief Function to free the memory allocated by the reserve_words function.
  *
  * This function frees the memory block that was allocated using the reserve_words function. The 
- * function takes in one input argument: a pointer to the first byte of the memory block. The 
- * function frees the memory block using the free function.
+ * function takes in one input argument: a pointer to the first byte of the memory block. Pool
+ * blocks go back to the free list of their class, in O(1), and the other blocks to free.
  *
- * @param src Pointer to the first byte of the memory block to be freed.
+ * @param src Pointer to the first byte of the memory block to be freed, may be NULL.
  *
  * @return void.
  */
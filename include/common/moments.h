@@ -0,0 +1,108 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file moments.h
+ * @brief File containing the declaration of the mergeable central moments.
+ *
+ * The mean and the second, third and fourth central moment sums of a set of samples are kept
+ * together so two sets can be combined with the pairwise update of Pebay (2008) without going back
+ * to the samples. Kernels reduce short blocks of samples to power sums around a shift close to the
+ * block, which keeps the sums small, and add each block with moments_add_block. The variance,
+ * skewness and kurtosis are read from the moments at the end.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __MOMENTS_H__
+#define __MOMENTS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Central moments of a set of samples.
+ */
+typedef struct
+{
+  uint64_t count;             /* Number of samples */
+  double mean;                /* Mean */
+  double m2;                  /* Sum of the squared differences from the mean */
+  double m3;                  /* Sum of the cubed differences from the mean */
+  double m4;                  /* Sum of the fourth powers of the differences from the mean */
+} stats_moments_t;
+
+/**
+ * @brief Function to reset moments to the moments of an empty set.
+ *
+ * @param moments Pointer to the moments.
+ *
+ * @return void.
+ */
+void moments_init(stats_moments_t * moments);
+
+/**
+ * @brief Function to add a block of samples given by its power sums around a shift.
+ *
+ * The power sums are s_p = sum((x - shift)^p) over the count samples of the block. A bin of a
+ * histogram is a block whose power sums are all 0 with the value of the bin as shift.
+ *
+ * @param moments Pointer to the moments to update.
+ * @param count   Number of samples of the block.
+ * @param shift   Value subtracted from every sample of the block.
+ * @param s1      Sum of the differences.
+ * @param s2      Sum of the squared differences.
+ * @param s3      Sum of the cubed differences.
+ * @param s4      Sum of the fourth powers of the differences.
+ *
+ * @return void.
+ */
+void moments_add_block(stats_moments_t * moments, uint64_t count, double shift,
+                       double s1, double s2, double s3, double s4);
+
+/**
+ * @brief Function to merge moments into other moments.
+ *
+ * @param dst Pointer to the moments to update.
+ * @param src Pointer to the moments to merge, not modified.
+ *
+ * @return void.
+ */
+void moments_merge(stats_moments_t * dst, const stats_moments_t * src);
+
+/**
+ * @brief Function to get the population variance of a set of samples.
+ *
+ * @param moments Pointer to the moments.
+ *
+ * @return Variance, 0 if the set is empty.
+ */
+double moments_variance(const stats_moments_t * moments);
+
+/**
+ * @brief Function to get the skewness of a set of samples.
+ *
+ * @param moments Pointer to the moments.
+ *
+ * @return Population skewness m3/m2^1.5, 0 if the variance is 0.
+ */
+double moments_skewness(const stats_moments_t * moments);
+
+/**
+ * @brief Function to get the kurtosis of a set of samples.
+ *
+ * @param moments Pointer to the moments.
+ *
+ * @return Population excess kurtosis m4/m2^2 - 3, 0 if the variance is 0.
+ */
+double moments_kurtosis(const stats_moments_t * moments);
+
+#endif /* __MOMENTS_H__ */
@@ -0,0 +1,70 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file pair.h
+ * @brief File containing the declaration of the two-array statistics kernels.
+ *
+ * One kernel per sample type (stats_pair_u8, stats_pair_u16, stats_pair_i32, stats_pair_f32 and
+ * stats_pair_f64) reads two arrays of paired samples x and y once, together, and returns their
+ * means, variances, covariance, Pearson correlation and least-squares regression line of y on x.
+ * Use the stats_pair_compute macro of stats.h to pick the kernel from the type of the arrays.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __PAIR_H__
+#define __PAIR_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Statistics of two arrays of paired samples.
+ *
+ * Variances and covariance are population values. Every field is 0 for empty arrays.
+ */
+typedef struct
+{
+  size_t count;               /* Number of pairs */
+  double mean_x;              /* Mean of x */
+  double mean_y;              /* Mean of y */
+  double variance_x;          /* Population variance of x */
+  double variance_y;          /* Population variance of y */
+  double covariance;          /* Population covariance of x and y */
+  double correlation;         /* Pearson correlation, 0 if either variance is 0 */
+  double slope;               /* Slope of the least-squares line y = slope * x + intercept, 0 if x is constant */
+  double intercept;           /* Intercept of the least-squares line */
+} stats_pair_t;
+
+/* Declares the kernel stats_pair_<suffix> of a sample type */
+#define PAIR_DECLARE(suffix, type)                                                              \
+stats_pair_t stats_pair_##suffix(const type * x, const type * y, size_t array_size);
+
+/**
+ * @brief Functions to compute the statistics of two arrays of paired samples in a single pass.
+ *
+ * Each function takes in three input arguments: pointers to the x and y arrays and their common
+ * size. Pair i is (x[i], y[i]).
+ *
+ * @param x          Pointer to the array of x samples.
+ * @param y          Pointer to the array of y samples.
+ * @param array_size Size of both arrays.
+ *
+ * @return Statistics of the pairs.
+ */
+PAIR_DECLARE(u8, uint8_t)
+PAIR_DECLARE(u16, uint16_t)
+PAIR_DECLARE(i32, int32_t)
+PAIR_DECLARE(f32, float)
+PAIR_DECLARE(f64, double)
+
+#endif /* __PAIR_H__ */
@@ -0,0 +1,141 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file parallel.h
+ * @brief File containing the declaration of the multithreaded reduction engine.
+ *
+ * The engine splits an array into cache-sized chunks, reduces the chunks on worker threads with the
+ * kernels returned by kernels_get and merges the partial results. It backs find_minimum,
+ * find_maximum, find_mean and every histogram based statistic. Arrays below a size threshold, and
+ * every array on platforms without POSIX threads (MSP432), are reduced on the calling thread.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __PARALLEL_H__
+#define __PARALLEL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined (HOST)
+#define PARALLEL_THREADS
+#endif
+
+/* Size of the chunks handed to the workers, small enough to stay in the L2 cache */
+#define PARALLEL_CHUNK_SIZE_B   (256u * 1024u)
+
+/* Default size below which arrays are reduced on the calling thread */
+#define PARALLEL_MIN_SIZE_B     (4u * 1024u * 1024u)
+
+/* Upper bound of the number of threads of one reduction */
+#define PARALLEL_MAX_THREADS    (64)
+
+/* Reductions that can be requested from parallel_reduce, combine them with | */
+#define PARALLEL_OP_MINIMUM     (0x01)
+#define PARALLEL_OP_MAXIMUM     (0x02)
+#define PARALLEL_OP_SUM         (0x04)
+#define PARALLEL_OP_HISTOGRAM   (0x08)
+
+/**
+ * @brief Result of parallel_reduce, only the requested fields are written.
+ */
+typedef struct
+{
+  uint8_t minimum;            /* Smallest element, 255 if empty */
+  uint8_t maximum;            /* Largest element, 0 if empty */
+  uint64_t sum;               /* Sum of all elements */
+} parallel_result_t;
+
+/**
+ * @brief Task run by parallel_run, index goes from 0 to the number of tasks minus one.
+ */
+typedef void (*parallel_task_t)(void * arg, size_t index);
+
+/**
+ * @brief Function to set the number of threads used by the reductions.
+ *
+ * @param threads Number of threads, 0 to use one thread per online CPU. Values above
+ *                PARALLEL_MAX_THREADS are clamped.
+ *
+ * @return void.
+ */
+void parallel_set_threads(size_t threads);
+
+/**
+ * @brief Function to get the number of threads used by the reductions.
+ *
+ * @return Number of threads, always 1 on platforms without threads.
+ */
+size_t parallel_get_threads(void);
+
+/**
+ * @brief Function to get the thread count given to parallel_set_threads.
+ *
+ * Unlike parallel_get_threads this returns 0 when the count follows the online CPUs, so callers
+ * that change the count for a while can restore exactly what was configured.
+ *
+ * @return Configured number of threads, 0 for one thread per online CPU.
+ */
+size_t parallel_get_configured_threads(void);
+
+/**
+ * @brief Function to set the size below which arrays are reduced on the calling thread.
+ *
+ * @param min_size Size in bytes, PARALLEL_MIN_SIZE_B by default.
+ *
+ * @return void.
+ */
+void parallel_set_threshold(size_t min_size);
+
+/**
+ * @brief Function to get the size below which arrays are reduced on the calling thread.
+ *
+ * @return Size in bytes.
+ */
+size_t parallel_get_threshold(void);
+
+/**
+ * @brief Function to reduce an array of unsigned char values on several threads.
+ *
+ * This function takes in five input arguments: a pointer to an array of unsigned char values, the
+ * size of the array, the reductions to compute, a pointer to the result and a pointer to a
+ * histogram. The array is traversed once: with PARALLEL_OP_HISTOGRAM the minimum, maximum and sum are
+ * derived from the counters, otherwise the requested kernels run back to back on every chunk of
+ * PARALLEL_CHUNK_SIZE_B bytes while it is still in cache.
+ *
+ * @param src       Pointer to the array of unsigned char values.
+ * @param length    Size of the array.
+ * @param ops       Combination of PARALLEL_OP_* flags.
+ * @param result    Pointer to the result, may be NULL if only the histogram is requested.
+ * @param histogram Pointer to 256 counters filled when PARALLEL_OP_HISTOGRAM is requested.
+ *
+ * @return void.
+ */
+void parallel_reduce(const uint8_t * src, size_t length, uint8_t ops, parallel_result_t * result, size_t * histogram);
+
+/**
+ * @brief Function to run a task once per index on several threads.
+ *
+ * This function calls task(arg, index) for every index below count, each call on its own thread,
+ * and returns when all calls have returned. Index 0 runs on the calling thread, and so does every
+ * index whose thread cannot be created.
+ *
+ * @param task  Task to run.
+ * @param arg   Argument passed to every call of the task.
+ * @param count Number of calls, at most PARALLEL_MAX_THREADS.
+ *
+ * @return void.
+ */
+void parallel_run(parallel_task_t task, void * arg, size_t count);
+
+#endif /* __PARALLEL_H__ */
@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file robust.h
+ * @brief File containing the declaration of the robust statistics of an array of unsigned char.
+ *
+ * The median, quartiles, interquartile range, median absolute deviation and Tukey fences are all
+ * read from the 256-bin histogram of the array. The absolute deviations from the median only take
+ * 256 values too, so their histogram is folded from the first one without reading the data again.
+ * Computing them costs one pass over the array, and flagging the outliers one more.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __ROBUST_H__
+#define __ROBUST_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stats.h"
+#include "scratch.h"
+
+/* Tukey inner fence multiplier: outliers lie more than 1.5 IQR outside the quartiles. Callers that
+   only want the far outliers pass 3.0, the outer fence, as k instead */
+#define ROBUST_TUKEY_K (1.5)
+
+/* Size in bytes of the outlier bitmap of an array */
+#define ROBUST_BITMAP_BYTES(array_size) (((array_size) + 7) / 8)
+
+/**
+ * @brief Robust statistics of an array of unsigned char values.
+ *
+ * The median and the median absolute deviation follow find_median, the mean of the two middle
+ * values truncated for even sizes. The quartiles follow find_percentiles.
+ */
+typedef struct
+{
+  size_t count;                 /* Number of samples */
+  unsigned char median;         /* Median as returned by find_median */
+  unsigned char q1;             /* First quartile, the 0.25 percentile */
+  unsigned char q3;             /* Third quartile, the 0.75 percentile */
+  unsigned char iqr;            /* Interquartile range, q3 minus q1 */
+  unsigned char mad;            /* Median absolute deviation from the median */
+  double lower_fence;           /* q1 - k * iqr, samples below it are outliers */
+  double upper_fence;           /* q3 + k * iqr, samples above it are outliers */
+} stats_robust_t;
+
+/**
+ * @brief Function to compute the robust statistics of an array in a single pass.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ *
+ * @return Robust statistics of the array, all zero if it is empty.
+ */
+stats_robust_t robust_compute(const unsigned char * array_pointer, size_t array_size, double k);
+
+/**
+ * @brief Function to compute the robust statistics of an array with scratch memory from an arena.
+ *
+ * The histogram and the deviation counters, at most SCRATCH_ROBUST_BYTES, come from the arena
+ * instead of the stack and are released before returning.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ * @param scratch       Pointer to the arena.
+ *
+ * @return Robust statistics of the array, all zero if it is empty or the arena is too small.
+ */
+stats_robust_t robust_compute_scratch(const unsigned char * array_pointer, size_t array_size, double k,
+                                      stats_scratch_t * scratch);
+
+/**
+ * @brief Function to derive the robust statistics from a histogram.
+ *
+ * This function does not read the data, so it also serves the histograms kept up to date by
+ * summary.h, window.h and dataset.h.
+ *
+ * @param histogram Pointer to STATS_HISTOGRAM_BINS counters.
+ * @param k         Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ *
+ * @return Robust statistics of the samples counted by the histogram.
+ */
+stats_robust_t robust_from_histogram(const size_t * histogram, double k);
+
+/**
+ * @brief Function to derive the robust statistics from a histogram with scratch memory from an arena.
+ *
+ * @param histogram Pointer to STATS_HISTOGRAM_BINS counters.
+ * @param k         Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ * @param scratch   Pointer to the arena, the deviation counters are taken from it and released.
+ *
+ * @return Robust statistics of the samples counted by the histogram, all zero if the arena is too small.
+ */
+stats_robust_t robust_from_histogram_scratch(const size_t * histogram, double k, stats_scratch_t * scratch);
+
+/**
+ * @brief Function to flag the outliers of an array in a bitmap.
+ *
+ * Bit i % 8 of byte i / 8 of the bitmap is set if sample i is outside the Tukey fences of the
+ * array. The fences are found with robust_compute, then a second pass writes the bitmap one byte
+ * at a time from a 256-entry lookup table of the outlier values.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ * @param bitmap        Pointer to ROBUST_BITMAP_BYTES(array_size) bytes, fully overwritten.
+ * @param robust        Pointer to the robust statistics used for the fences, may be NULL.
+ *
+ * @return Number of outliers.
+ */
+size_t robust_flag_outliers(const unsigned char * array_pointer, size_t array_size, double k,
+                            uint8_t * bitmap, stats_robust_t * robust);
+
+/**
+ * @brief Function to flag the outliers of an array in a bitmap with scratch memory from an arena.
+ *
+ * The histogram, the deviation counters and the lookup table, at most SCRATCH_ROBUST_BYTES, come
+ * from the arena instead of the stack and are released before returning. If the arena is too small
+ * the bitmap is left untouched and the robust statistics are all zero.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Tukey fence multiplier, usually ROBUST_TUKEY_K.
+ * @param bitmap        Pointer to ROBUST_BITMAP_BYTES(array_size) bytes.
+ * @param robust        Pointer to the robust statistics used for the fences, may be NULL.
+ * @param scratch       Pointer to the arena.
+ *
+ * @return Number of outliers, 0 if the arena is too small.
+ */
+size_t robust_flag_outliers_scratch(const unsigned char * array_pointer, size_t array_size, double k,
+                                    uint8_t * bitmap, stats_robust_t * robust, stats_scratch_t * scratch);
+
+#endif /* __ROBUST_H__ */
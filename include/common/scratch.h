@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file scratch.h
+ * @brief File containing the declaration of the scratch arena.
+ *
+ * A scratch arena hands out temporary memory from a buffer owned by the caller, which can be a
+ * static array, so the _scratch variants of the statistics functions never allocate and never put
+ * an array sized by the input on the stack. Blocks are released in the reverse order of their
+ * allocation by going back to a mark, and every _scratch function releases what it took before it
+ * returns, so one arena serves any number of calls.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __SCRATCH_H__
+#define __SCRATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "selection.h"
+
+/* Alignment of every block, enough for any sample or counter type */
+#define SCRATCH_ALIGN (8)
+
+/* Scratch bytes needed by find_median_scratch, find_kth_scratch, find_percentiles_u8_scratch,
+   stats_mode_u8_scratch, find_top_k_scratch and find_bottom_k_scratch */
+#define SCRATCH_SELECT_BYTES (SELECT_BUCKETS * sizeof(size_t) + SCRATCH_ALIGN)
+
+/* Scratch bytes needed by the robust_*_scratch functions */
+#define SCRATCH_ROBUST_BYTES (2 * SELECT_BUCKETS * sizeof(size_t) + SELECT_BUCKETS + 3 * SCRATCH_ALIGN)
+
+/* Scratch bytes needed by the weighted statistics _scratch functions */
+#define SCRATCH_WEIGHTED_BYTES (SELECT_BUCKETS * sizeof(double) + SCRATCH_ALIGN)
+
+/* Scratch bytes needed by stats_mode_<suffix>_scratch for the other sample types, the copy and the
+   radix scratch */
+#define SCRATCH_MODE_BYTES(array_size, sample_size) \
+  (2 * (array_size) * (sample_size) + 2 * SCRATCH_ALIGN)
+
+/* Scratch bytes needed by find_percentiles_<suffix>_scratch for the other sample types */
+#define SCRATCH_PERCENTILES_BYTES(array_size, sample_size, nq) \
+  (2 * (nq) * sizeof(size_t) + (array_size) * (sample_size) + 2 * SCRATCH_ALIGN)
+
+/**
+ * @brief What a _scratch function may do with its input array.
+ */
+typedef enum
+{
+  STATS_KEEP_INPUT = 0,       /* The input is left untouched, copies go to the arena */
+  STATS_MAY_REORDER = 1       /* The input may be reordered in place, which saves the copy */
+} stats_input_t;
+
+/**
+ * @brief Scratch arena over a buffer owned by the caller.
+ */
+typedef struct
+{
+  unsigned char * base;       /* First byte of the buffer */
+  size_t size;                /* Size of the buffer */
+  size_t used;                /* Bytes handed out, including the alignment padding */
+} stats_scratch_t;
+
+/**
+ * @brief Function to create an empty arena over a buffer.
+ *
+ * @param scratch Pointer to the arena.
+ * @param buffer  Pointer to the buffer, may be NULL if size is 0.
+ * @param size    Size of the buffer in bytes.
+ *
+ * @return void.
+ */
+void scratch_init(stats_scratch_t * scratch, void * buffer, size_t size);
+
+/**
+ * @brief Function to take a block from an arena.
+ *
+ * @param scratch Pointer to the arena.
+ * @param bytes   Size of the block.
+ *
+ * @return Pointer to a block aligned to SCRATCH_ALIGN, or NULL if the arena is too small.
+ */
+void * scratch_alloc(stats_scratch_t * scratch, size_t bytes);
+
+/**
+ * @brief Function to remember the state of an arena.
+ *
+ * @param scratch Pointer to the arena.
+ *
+ * @return Mark to pass to scratch_release.
+ */
+size_t scratch_mark(const stats_scratch_t * scratch);
+
+/**
+ * @brief Function to release every block taken since a mark.
+ *
+ * @param scratch Pointer to the arena.
+ * @param mark    Value returned by scratch_mark.
+ *
+ * @return void.
+ */
+void scratch_release(stats_scratch_t * scratch, size_t mark);
+
+#endif /* __SCRATCH_H__ */
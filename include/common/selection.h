@@ -0,0 +1,145 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file selection.h
+ * @brief File containing the declaration of the order statistic selection engine.
+ *
+ * The functions declared in this file return the k-th smallest element of an array of unsigned
+ * char in linear time. Two engines are provided: a 256-bucket counting path that does not modify
+ * the input, and an in-place introselect (quickselect with a median-of-medians fallback) that
+ * reorders the input. The median of a histogram and the rank of a quantile are also defined here
+ * once, for every module that derives them.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __SELECTION_H__
+#define __SELECTION_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Number of buckets of the counting path, one per unsigned char value */
+#define SELECT_BUCKETS          (256)
+
+/* Inputs up to this size are copied and selected in place instead of counted */
+#define SELECT_SMALL_SIZE       (64)
+
+/* Partitions up to this size are finished with an insertion sort */
+#define SELECT_INSERTION_CUTOFF (16)
+
+/**
+ * @brief Function to count the occurrences of every value of an array of unsigned char.
+ *
+ * This function takes in three input arguments: a pointer to an array of unsigned char values, the
+ * size of the array and a pointer to the histogram to fill. The histogram is cleared before counting.
+ * Large arrays are counted on several threads (see parallel.h).
+ *
+ * @param src       Pointer to the array of unsigned char values.
+ * @param length    Size of the array.
+ * @param histogram Pointer to an array of SELECT_BUCKETS counters.
+ *
+ * @return void.
+ */
+void select_histogram(const uint8_t * src, size_t length, size_t * histogram);
+
+/**
+ * @brief Function to find the k-th smallest element of an array using a 256-bucket histogram.
+ *
+ * This function takes in three input arguments: a pointer to an array of unsigned char values, the
+ * size of the array and the zero based rank to select. The function counts the occurrences of every
+ * value in a single pass and walks the histogram up to the requested rank. The input is not modified.
+ *
+ * @param src    Pointer to the array of unsigned char values.
+ * @param length Size of the array.
+ * @param k      Zero based rank in ascending order (0 is the minimum).
+ *
+ * @return The k-th smallest element, or 0 if k is out of range.
+ */
+uint8_t select_kth_counting(const uint8_t * src, size_t length, size_t k);
+
+/**
+ * @brief Function to find the k-th smallest element of an array by partitioning it in place.
+ *
+ * This function takes in three input arguments: a pointer to an array of unsigned char values, the
+ * size of the array and the zero based rank to select. The function runs a quickselect with
+ * median-of-three pivots and switches to median-of-medians pivots when the recursion budget is
+ * exhausted, which bounds the worst case to linear time. The array is reordered so that the element
+ * at index k is the k-th smallest, every element before it is not greater and every element after
+ * it is not smaller.
+ *
+ * @param src    Pointer to the array of unsigned char values.
+ * @param length Size of the array.
+ * @param k      Zero based rank in ascending order (0 is the minimum).
+ *
+ * @return The k-th smallest element, or 0 if k is out of range.
+ */
+uint8_t select_kth_inplace(uint8_t * src, size_t length, size_t k);
+
+/**
+ * @brief Function to find the k-th smallest element described by a 256-bucket histogram.
+ *
+ * This function takes in two input arguments: a pointer to a histogram holding the number of
+ * occurrences of each unsigned char value and the zero based rank to select. The function walks the
+ * histogram until the cumulative count exceeds the requested rank.
+ *
+ * @param histogram Pointer to an array of SELECT_BUCKETS counters.
+ * @param k         Zero based rank in ascending order (0 is the minimum).
+ *
+ * @return The k-th smallest element, or 0 if k is out of range.
+ */
+uint8_t select_kth_histogram(const size_t * histogram, size_t k);
+
+/**
+ * @brief Function to find the median of the samples described by a 256-bucket histogram.
+ *
+ * The median of an even number of samples is the mean of both middle values rounded down, like
+ * find_median. Every median of the library built from a histogram goes through this function.
+ *
+ * @param histogram Pointer to an array of SELECT_BUCKETS counters.
+ * @param count     Number of samples, the sum of the counters.
+ *
+ * @return The median, or 0 if count is 0.
+ */
+uint8_t select_median_histogram(const size_t * histogram, size_t count);
+
+/**
+ * @brief Function to find the median of a histogram from a known position.
+ *
+ * Same as select_median_histogram, but the walk starts at value instead of 0, so a caller that
+ * keeps a cursor close to the middle (see window.h) only walks a few buckets. The select_median_from_u64
+ * variant takes 64-bit counters.
+ *
+ * @param histogram Pointer to an array of SELECT_BUCKETS counters.
+ * @param count     Number of samples, the sum of the counters.
+ * @param value     First value to look at, not greater than the lower middle value.
+ * @param below     Number of samples smaller than value.
+ *
+ * @return The median, or 0 if count is 0.
+ */
+uint8_t select_median_from(const size_t * histogram, size_t count, size_t value, size_t below);
+uint8_t select_median_from_u64(const uint64_t * histogram, uint64_t count, size_t value, uint64_t below);
+
+/**
+ * @brief Function to convert a quantile into the zero based rank of a sample.
+ *
+ * Quantile q, clamped to [0, 1], is the sample of rank round(q * (count - 1)), so 0 is the minimum
+ * and 1 the maximum. Every quantile of the library uses this rank.
+ *
+ * @param q     Quantile.
+ * @param count Number of samples.
+ *
+ * @return The rank, 0 if count is 0.
+ */
+size_t select_quantile_rank(double q, size_t count);
+
+#endif /* __SELECTION_H__ */
@@ -0,0 +1,132 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file sketch.h
+ * @brief File containing the declaration of the streaming quantile sketch.
+ *
+ * A sketch summarizes a stream of double samples of any length in a fixed amount of memory, about
+ * 6 KiB, and answers approximate quantile and cumulative distribution queries. It is a KLL sketch:
+ * samples are kept in levels, a sample of level h stands for 2^h samples of the stream, and a full
+ * level is sorted and every other sample of it, starting at a random offset, is promoted to the next
+ * level. With SKETCH_K of 200 the rank error of a query is about 1.7% of the count with 99%
+ * confidence, however long the stream is. Sketches of separate streams can be merged, and the merge
+ * has the same error guarantee.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __SKETCH_H__
+#define __SKETCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Accuracy parameter, the capacity of the top level. The rank error is about 1.7/K */
+#define SKETCH_K            (200)
+
+/* Smallest capacity of a level */
+#define SKETCH_MIN_WIDTH    (2)
+
+/* Number of levels, enough for 2^64 samples */
+#define SKETCH_MAX_LEVELS   (64)
+
+/* Number of samples the levels can hold together, the level capacities add up to less than this */
+#define SKETCH_CAPACITY     (3 * SKETCH_K + SKETCH_MIN_WIDTH * SKETCH_MAX_LEVELS)
+
+/**
+ * @brief State of a quantile sketch.
+ *
+ * The levels are stored back to back in items, from the top level to level 0, so new samples are
+ * appended at the end.
+ */
+typedef struct
+{
+  uint64_t count;                               /* Number of samples inserted */
+  double minimum;                               /* Smallest sample, 0 if empty */
+  double maximum;                               /* Largest sample, 0 if empty */
+  uint32_t random;                              /* State of the compaction coin */
+  uint8_t sorted;                               /* Every level is sorted */
+  size_t levels;                                /* Number of levels in use */
+  size_t capacity;                              /* Sum of the capacities of the levels in use */
+  size_t stored;                                /* Number of samples held by the levels */
+  size_t level_size[SKETCH_MAX_LEVELS];         /* Number of samples held by every level */
+  double items[SKETCH_CAPACITY];                /* Samples of every level */
+} stats_sketch_t;
+
+/**
+ * @brief Function to reset a sketch to the empty state.
+ *
+ * @param sketch Pointer to the sketch.
+ *
+ * @return void.
+ */
+void sketch_init(stats_sketch_t * sketch);
+
+/**
+ * @brief Function to add a sample to a sketch.
+ *
+ * NaN samples are ignored. The amortized cost is O(log K) per sample.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param sample Sample to add.
+ *
+ * @return void.
+ */
+void sketch_insert(stats_sketch_t * sketch, double sample);
+
+/**
+ * @brief Function to add an array of samples to a sketch.
+ *
+ * @param sketch        Pointer to the sketch.
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ *
+ * @return void.
+ */
+void sketch_insert_array(stats_sketch_t * sketch, const double * array_pointer, size_t array_size);
+
+/**
+ * @brief Function to merge a sketch into another one.
+ *
+ * After the call dst summarizes the samples of both sketches.
+ *
+ * @param dst Pointer to the sketch to update.
+ * @param src Pointer to the sketch to merge, not modified.
+ *
+ * @return void.
+ */
+void sketch_merge(stats_sketch_t * dst, const stats_sketch_t * src);
+
+/**
+ * @brief Function to estimate a quantile of the samples of a sketch.
+ *
+ * The samples of every level are sorted in place the first time a quantile is queried after an
+ * update, which does not change what the sketch describes.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param q      Quantile between 0 (minimum) and 1 (maximum), 0.5 is the median.
+ *
+ * @return Smallest sample whose estimated rank is at least q*count, 0 if empty.
+ */
+double sketch_quantile(stats_sketch_t * sketch, double q);
+
+/**
+ * @brief Function to estimate the cumulative distribution of the samples of a sketch.
+ *
+ * @param sketch Pointer to the sketch.
+ * @param x      Value to look up.
+ *
+ * @return Estimated fraction of the samples not greater than x, 0 if empty.
+ */
+double sketch_cdf(const stats_sketch_t * sketch, double x);
+
+#endif /* __SKETCH_H__ */
@@ -0,0 +1,197 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file sort.h
+ * @brief File containing the declaration of the sort engine.
+ *
+ * Three sort paths are provided, from the most to the least specialized: a counting sort for 8-bit
+ * data in O(n + 256), an LSD radix sort for 16 and 32-bit integers in O(n) with one pass per byte,
+ * and an introsort (quicksort with an insertion sort cutoff and a heapsort fallback) for any element
+ * type ordered by a comparator, in O(n log n) worst case. sort_array uses the counting sort.
+ *
+ * The counting sort and the introsort also have parallel variants that run on the threads of the
+ * parallel engine, sort_array_parallel uses the parallel counting sort.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __SORT_H__
+#define __SORT_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Partitions up to this many elements are finished with an insertion sort */
+#define SORT_INSERTION_CUTOFF (16)
+
+/* Smallest run sorted by one thread of sort_generic_parallel */
+#define SORT_PARALLEL_MIN_RUN (4096)
+
+/* Partial sorts of up to this many elements keep them in a bounded heap */
+#define SORT_PARTIAL_HEAP_MAX (32)
+
+/**
+ * @brief Order of the sorted output.
+ */
+typedef enum
+{
+  SORT_ASCENDING = 0,         /* Smallest element first */
+  SORT_DESCENDING = 1         /* Largest element first, the order of sort_array */
+} sort_order_t;
+
+/**
+ * @brief Function to sort an array of unsigned char values with a counting sort.
+ *
+ * This function counts the occurrences of every value in one pass over the array and rewrites the
+ * array from the histogram. It does not need any scratch memory.
+ *
+ * @param src    Pointer to the array of unsigned char values.
+ * @param length Size of the array.
+ * @param order  Order of the sorted output.
+ *
+ * @return void.
+ */
+void sort_counting_u8(uint8_t * src, size_t length, sort_order_t order);
+
+/**
+ * @brief Function to sort an array of unsigned char values with a counting sort on several threads.
+ *
+ * The histogram is built by the parallel engine from per-chunk histograms, then every thread
+ * rewrites its own slice of the array from the prefix counts of the merged histogram. Arrays below
+ * the threshold of parallel_get_threshold are sorted on the calling thread.
+ *
+ * @param src    Pointer to the array of unsigned char values.
+ * @param length Size of the array.
+ * @param order  Order of the sorted output.
+ *
+ * @return void.
+ */
+void sort_counting_u8_parallel(uint8_t * src, size_t length, sort_order_t order);
+
+/**
+ * @brief Function to sort an array of 16-bit unsigned integers with an LSD radix sort.
+ *
+ * @param src     Pointer to the array to sort.
+ * @param length  Number of elements.
+ * @param scratch Pointer to a scratch array of at least length elements.
+ * @param order   Order of the sorted output.
+ *
+ * @return void.
+ */
+void sort_radix_u16(uint16_t * src, size_t length, uint16_t * scratch, sort_order_t order);
+
+/**
+ * @brief Function to sort an array of 32-bit unsigned integers with an LSD radix sort.
+ *
+ * Passes over a byte that is the same in every element are skipped.
+ *
+ * @param src     Pointer to the array to sort.
+ * @param length  Number of elements.
+ * @param scratch Pointer to a scratch array of at least length elements.
+ * @param order   Order of the sorted output.
+ *
+ * @return void.
+ */
+void sort_radix_u32(uint32_t * src, size_t length, uint32_t * scratch, sort_order_t order);
+
+/**
+ * @brief Function to sort an array of 32-bit signed integers with an LSD radix sort.
+ *
+ * The sign bit is flipped so the signed order matches the unsigned order, the array is sorted with
+ * sort_radix_u32 and the sign bit is flipped back.
+ *
+ * @param src     Pointer to the array to sort.
+ * @param length  Number of elements.
+ * @param scratch Pointer to a scratch array of at least length elements.
+ * @param order   Order of the sorted output.
+ *
+ * @return void.
+ */
+void sort_radix_i32(int32_t * src, size_t length, int32_t * scratch, sort_order_t order);
+
+/**
+ * @brief Function to sort an array of any element type with an introsort.
+ *
+ * This function has the same arguments as the standard qsort and sorts in ascending order of the
+ * comparator. It runs a median-of-three quicksort, finishes short partitions with an insertion sort
+ * and switches to a heapsort when the recursion gets deeper than 2*log2(n), so the worst case is
+ * O(n log n). The sort is not stable and does not allocate.
+ *
+ * @param base    Pointer to the first element.
+ * @param count   Number of elements.
+ * @param size    Size of one element in bytes.
+ * @param compare Comparator returning a negative, zero or positive value like for qsort.
+ *
+ * @return void.
+ */
+void sort_generic(void * base, size_t count, size_t size, int (*compare)(const void *, const void *));
+
+/**
+ * @brief Function to select several order statistics of an array of any element type at once.
+ *
+ * This function reorders the array so that the element at every requested rank is the one a full
+ * sort would put there. It runs the partitions of sort_generic but only recurses into the sides
+ * that contain a requested rank, so selecting a handful of ranks costs a few passes over the array
+ * instead of a full sort. Elements between two requested ranks are left unordered.
+ *
+ * @param base       Pointer to the first element.
+ * @param count      Number of elements.
+ * @param size       Size of one element in bytes.
+ * @param compare    Comparator returning a negative, zero or positive value like for qsort.
+ * @param ranks      Zero based ranks to select, in ascending order, duplicates allowed.
+ * @param rank_count Number of ranks.
+ *
+ * @return void.
+ */
+void sort_select(void * base, size_t count, size_t size, int (*compare)(const void *, const void *),
+                 const size_t * ranks, size_t rank_count);
+
+/**
+ * @brief Function to sort the first elements of an array of any element type.
+ *
+ * After the call the first k elements are the k smallest of the array in ascending order of the
+ * comparator, the other elements are left unordered. Up to SORT_PARTIAL_HEAP_MAX elements are
+ * collected in a bounded max-heap in one pass over the array, O(n log k). Larger k select the k-th
+ * element with sort_select and sort the elements before it with sort_generic, O(n + k log k).
+ *
+ * @param base    Pointer to the first element.
+ * @param count   Number of elements.
+ * @param size    Size of one element in bytes.
+ * @param compare Comparator returning a negative, zero or positive value like for qsort.
+ * @param k       Number of elements to sort, the whole array is sorted if k is not less than count.
+ *
+ * @return void.
+ */
+void sort_partial(void * base, size_t count, size_t size, int (*compare)(const void *, const void *), size_t k);
+
+/**
+ * @brief Function to sort an array of any element type with a parallel merge sort.
+ *
+ * The array is split into one run per thread and every run is sorted by sort_generic. The runs are
+ * then merged pairwise between the array and the scratch array until one run is left. Every merge
+ * round is split into equal slices of the output, one per thread, by a binary search along the
+ * merge path, so the threads stay busy even in the last rounds. Equal elements of the left run are
+ * written first. Arrays below the threshold of parallel_get_threshold, arrays shorter than two runs
+ * of SORT_PARALLEL_MIN_RUN elements and calls without scratch memory use sort_generic.
+ *
+ * @param base    Pointer to the first element.
+ * @param count   Number of elements.
+ * @param size    Size of one element in bytes.
+ * @param compare Comparator returning a negative, zero or positive value like for qsort.
+ * @param scratch Pointer to a scratch array of count*size bytes, may be NULL.
+ *
+ * @return void.
+ */
+void sort_generic_parallel(void * base, size_t count, size_t size, int (*compare)(const void *, const void *),
+                           void * scratch);
+
+#endif /* __SORT_H__ */
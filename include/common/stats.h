@@ -14,7 +14,11 @@
  *
  * The functions declared in this file may include common statistical operations such as calculating 
  * the maximum, minimum, mean, and median of the array. The declaration of each function specifies its 
- * name, argument list, and return type.
+ * name, argument list, and return type. Array sizes and indexes are size_t and sums are accumulated in 
+ * 64 bits, so arrays larger than 4 GiB are supported. Arrays of other sample types are handled by the
+ * typed kernels of stats_typed.h through the stats_compute macro, and pairs of arrays by the kernels of
+ * pair.h through the stats_pair_compute macro. Weighted arrays are handled by weighted.h through the
+ * stats_weighted_compute and find_weighted_percentiles macros.
  *
  * @author Julian Hoyos
  * @date 26/03/2023
@@ -23,23 +27,83 @@
 #ifndef __STATS_H__
 #define __STATS_H__
 
+#include <stddef.h>
+#include <stdint.h>
+#include "stats_typed.h"
+#include "pair.h"
+#include "weighted.h"
+
+/* Number of histogram bins, one per unsigned char value */
+#define STATS_HISTOGRAM_BINS (256)
+
+/**
+ * @brief Descriptive summary of an array of unsigned char values.
+ *
+ * Filled by compute_summary in a single pass over the data. Every other field is derived from the
+ * histogram once the pass is over, which also makes summaries of separate shards mergeable (see
+ * summary.h).
+ */
+typedef struct
+{
+  size_t count;                               /* Number of samples */
+  uint64_t sum;                               /* Sum of all samples */
+  uint64_t sum_squares;                       /* Sum of the squares of all samples */
+  unsigned char minimum;                      /* Smallest sample, 0 if empty */
+  unsigned char maximum;                      /* Largest sample, 0 if empty */
+  unsigned char mean;                         /* Truncated mean, 0 if empty */
+  unsigned char median;                       /* Median as returned by find_median */
+  unsigned char mode;                         /* Most frequent sample, the smallest on ties, 0 if empty */
+  unsigned char range;                        /* Maximum minus minimum */
+  double variance;                            /* Population variance, 0 if empty */
+  double stddev;                              /* Population standard deviation */
+  double skewness;                            /* Population skewness, 0 if the variance is 0 */
+  double kurtosis;                            /* Population excess kurtosis, 0 if the variance is 0 */
+  size_t histogram[STATS_HISTOGRAM_BINS];     /* Occurrences of every value */
+} stats_summary_t;
 
 /**
  * @brief Function to print the statistics of an array including maximum, minimum, mean and median.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array. The function then iterates through the array to determine maximum, minimum, media, 
- * and median values. Once all the statistical properties have been calculated, the function prints them 
- * to the console. 
+ * size of the array. The function computes the maximum, minimum, mean, median, mode, range, variance,
+ * standard deviation, skewness and kurtosis with a single pass over the array (see compute_summary).
+ * Once all the statistical properties have been calculated, the function prints them to the console. 
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return void.
  */
-void print_statistics(unsigned char* array_pointer, unsigned int array_size);
+void print_statistics(unsigned char* array_pointer, size_t array_size);
+
+/**
+ * @brief Function to print a summary computed earlier.
+ *
+ * This function prints the same two lines as print_statistics from a summary, for callers that keep
+ * their summaries up to date without a rescan (see dataset.h).
+ *
+ * @param summary Pointer to the summary.
+ *
+ * @return void.
+ */
+void print_summary(const stats_summary_t * summary);
 
 
+/**
+ * @brief Function to compute the summary statistics of an array in a single pass.
+ *
+ * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
+ * size of the array. The function reads every element exactly once to build a 256-bin histogram, then
+ * derives the minimum, maximum, sum, sum of squares, mean, median, mode, range and the central
+ * moments from the histogram without sorting.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ *
+ * @return Summary of the input array.
+ */
+stats_summary_t compute_summary(const unsigned char* array_pointer, size_t array_size);
+
 /**
  * @brief Function to print an array of unsigned char.
  *
@@ -51,72 +115,348 @@ void print_statistics(unsigned char* array_pointer, unsigned int array_size);
  *
  * @return void.
  */
-void print_array(unsigned char* array_pointer, unsigned int array_size);
+void print_array(unsigned char* array_pointer, size_t array_size);
 
 /**
  * @brief Function to calculate the median value of an array of unsigned char values.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array and returns the calculated median value as a single numerical value.
+ * size of the array and returns the calculated median value as a single numerical value. The middle
+ * elements are found with the linear time selection engine, the input array is not modified.
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return Median value of the input array.
  */
-unsigned char find_median(unsigned char* array_pointer, unsigned int array_size);
+unsigned char find_median(unsigned char* array_pointer, size_t array_size);
+
+/**
+ * @brief Function to calculate the median value of an array with scratch memory from an arena.
+ *
+ * This function returns the same median as find_median. Its temporary memory, at most
+ * SCRATCH_SELECT_BYTES, comes from the arena instead of the stack. With STATS_MAY_REORDER the
+ * median is selected in place in linear time, which reorders the array and uses no scratch memory.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param scratch       Pointer to the arena, every block taken is released before returning.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return Median value of the input array, or 0 if the arena is too small.
+ */
+unsigned char find_median_scratch(unsigned char* array_pointer, size_t array_size,
+                                  stats_scratch_t* scratch, stats_input_t input);
+
+/**
+ * @brief Function to find the k-th smallest value of an array of unsigned char values.
+ *
+ * This function takes in three input arguments: a pointer to an array of unsigned char values, the 
+ * size of the array and a zero based rank. It returns the k-th order statistic in linear time using
+ * a 256-bucket counting pass, or an introselect over a small copy for short arrays. The input array
+ * is not modified.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Zero based rank in ascending order (0 is the minimum).
+ *
+ * @return K-th smallest value of the input array, or 0 if k is not less than array_size.
+ */
+unsigned char find_kth(unsigned char* array_pointer, size_t array_size, size_t k);
+
+/**
+ * @brief Function to find the k-th smallest value of an array with scratch memory from an arena.
+ *
+ * This function returns the same value as find_kth, with the same use of the arena and of the
+ * input flag as find_median_scratch.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Zero based rank in ascending order (0 is the minimum).
+ * @param scratch       Pointer to the arena, every block taken is released before returning.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return K-th smallest value of the input array, or 0 if k is out of range or the arena is too small.
+ */
+unsigned char find_kth_scratch(unsigned char* array_pointer, size_t array_size, size_t k,
+                               stats_scratch_t* scratch, stats_input_t input);
+
+/**
+ * @brief Function to find the largest values of an array of unsigned char values.
+ *
+ * This function writes the first k values sort_array would produce, without sorting the array.
+ * Long arrays are counted once and the histogram is walked down from 255, in O(n + 256 + k). Short
+ * arrays are copied and partially sorted (see sort_partial). The input array is not modified.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Number of values to find.
+ * @param out           Pointer to at least k unsigned char values, largest first.
+ *
+ * @return Number of values written, the smaller of k and array_size.
+ */
+size_t find_top_k(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out);
+
+/**
+ * @brief Function to find the smallest values of an array of unsigned char values.
+ *
+ * This function writes the last k values sort_array would produce, in the same descending order,
+ * with the same engines as find_top_k. The input array is not modified.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Number of values to find.
+ * @param out           Pointer to at least k unsigned char values, largest first.
+ *
+ * @return Number of values written, the smaller of k and array_size.
+ */
+size_t find_bottom_k(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out);
+
+/**
+ * @brief Functions to find the largest or smallest values of an array with scratch memory from an arena.
+ *
+ * These functions write the same values as find_top_k and find_bottom_k but take their temporary
+ * memory from the arena, at most SCRATCH_SELECT_BYTES. With STATS_MAY_REORDER short arrays are
+ * partially sorted in place instead of on a copy, long arrays are never reordered.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ * @param k             Number of values to find.
+ * @param out           Pointer to at least k unsigned char values, largest first.
+ * @param scratch       Pointer to the arena, every block taken is released before returning.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return Number of values written, the smaller of k and array_size, or 0 if the arena is too small.
+ */
+size_t find_top_k_scratch(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out,
+                          stats_scratch_t* scratch, stats_input_t input);
+size_t find_bottom_k_scratch(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out,
+                             stats_scratch_t* scratch, stats_input_t input);
 
 /**
  * @brief Function to calculate the mean value of an array of unsigned char values.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array and returns the calculated mean value as a single numerical value.
+ * size of the array and returns the calculated mean value as a single numerical value. The sum is
+ * accumulated in 64 bits and an empty array has a mean of 0. Large arrays are reduced on several
+ * threads (see parallel.h).
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return Mean value of the input array.
  */
-unsigned char find_mean(unsigned char* array_pointer, unsigned int array_size);
+unsigned char find_mean(unsigned char* array_pointer, size_t array_size);
 
 /**
  * @brief Function to find the maximum value of an array of unsigned char values.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array and returns the maximum value as a single numerical value.
+ * size of the array and returns the maximum value as a single numerical value, using the same
+ * reduction engine as find_mean.
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return Maximum value of the input array.
  */
-unsigned char find_maximum(unsigned char* array_pointer, unsigned int array_size);
+unsigned char find_maximum(unsigned char* array_pointer, size_t array_size);
 
 /**
  * @brief Function to find the minimum value of an array of unsigned char values.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array and returns the minimum value as a single numerical value.
+ * size of the array and returns the minimum value as a single numerical value, using the same
+ * reduction engine as find_mean.
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return Minimum value of the input array.
  */
-unsigned char find_minimum(unsigned char* array_pointer, unsigned int array_size);
+unsigned char find_minimum(unsigned char* array_pointer, size_t array_size);
 
 /**
  * @brief Function to sort an array from the largest to the smallest value.
  *
  * This function takes in two input arguments: a pointer to an array of unsigned char values and the 
- * size of the array. The function then iterates through the array to sort the elements in descending
- * order.
+ * size of the array. The elements are sorted in descending order with the counting sort of the sort
+ * engine, in O(n + 256) time and without scratch memory.
  *
  * @param array_pointer Pointer to the array of unsigned char values.
  * @param array_size    Size of the array.
  *
  * @return void.
  */
-void sort_array(unsigned char* array_pointer, unsigned int array_size);
+void sort_array(unsigned char* array_pointer, size_t array_size);
+
+/**
+ * @brief Function to sort an array from the largest to the smallest value on several threads.
+ *
+ * This function takes the same arguments and produces the same order as sort_array. The threads of
+ * the parallel engine build per-chunk histograms, which are merged, and then write their own slices
+ * of the output from the merged prefix counts. Arrays below parallel_get_threshold are sorted on the
+ * calling thread.
+ *
+ * @param array_pointer Pointer to the array of unsigned char values.
+ * @param array_size    Size of the array.
+ *
+ * @return void.
+ */
+void sort_array_parallel(unsigned char* array_pointer, size_t array_size);
+
+/**
+ * @brief Macro to compute the statistics of an array of any supported sample type.
+ *
+ * The kernel of stats_typed.h matching the type of array_pointer (uint8_t, uint16_t, int32_t, float
+ * or double, const or not) is selected at compile time, and the result type is the result type of
+ * that kernel. Pointers to any other type do not compile.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ *
+ * @return Statistics of the input array.
+ */
+#define stats_compute(array_pointer, array_size) _Generic((array_pointer), \
+  uint8_t *: stats_u8, const uint8_t *: stats_u8,                           \
+  uint16_t *: stats_u16, const uint16_t *: stats_u16,                       \
+  int32_t *: stats_i32, const int32_t *: stats_i32,                         \
+  float *: stats_f32, const float *: stats_f32,                             \
+  double *: stats_f64, const double *: stats_f64)(array_pointer, array_size)
+
+/**
+ * @brief Macro to find the most frequent sample of an array of any supported sample type.
+ *
+ * The stats_mode_* function of stats_typed.h matching the type of array_pointer is selected at
+ * compile time. Only stats_u8 reports the mode itself, the other kernels leave it to this macro.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param mode          Pointer to a sample of the type of the array, only written when found.
+ *
+ * @return 1 if the mode was found, 0 if the array is empty or the copy cannot be allocated.
+ */
+#define stats_mode(array_pointer, array_size, mode) _Generic((array_pointer), \
+  uint8_t *: stats_mode_u8, const uint8_t *: stats_mode_u8,                    \
+  uint16_t *: stats_mode_u16, const uint16_t *: stats_mode_u16,                \
+  int32_t *: stats_mode_i32, const int32_t *: stats_mode_i32,                  \
+  float *: stats_mode_f32, const float *: stats_mode_f32,                      \
+  double *: stats_mode_f64, const double *: stats_mode_f64)(array_pointer, array_size, mode)
+
+/**
+ * @brief Macro to find the most frequent sample of an array with scratch memory from an arena.
+ *
+ * The stats_mode_*_scratch function of stats_typed.h matching the type of array_pointer is
+ * selected at compile time. The array is not const since STATS_MAY_REORDER lets the sort reorder it.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param mode          Pointer to a sample of the type of the array, only written when found.
+ * @param scratch       Pointer to the arena.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return 1 if the mode was found, 0 if the array is empty or the arena is too small.
+ */
+#define stats_mode_scratch(array_pointer, array_size, mode, scratch, input) _Generic((array_pointer), \
+  uint8_t *: stats_mode_u8_scratch, uint16_t *: stats_mode_u16_scratch,                               \
+  int32_t *: stats_mode_i32_scratch, float *: stats_mode_f32_scratch,                                 \
+  double *: stats_mode_f64_scratch)(array_pointer, array_size, mode, scratch, input)
+
+/**
+ * @brief Macro to find several percentiles of an array with scratch memory from an arena.
+ *
+ * The find_percentiles_*_scratch function of stats_typed.h matching the type of array_pointer is
+ * selected at compile time. The array is not const since STATS_MAY_REORDER lets the selection
+ * reorder it.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param qs            Pointer to the quantiles to find, between 0 and 1.
+ * @param nq            Number of quantiles.
+ * @param out           Pointer to nq samples of the type of the array.
+ * @param scratch       Pointer to the arena.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return nq, or 0 if the array is empty or the arena is too small.
+ */
+#define find_percentiles_scratch(array_pointer, array_size, qs, nq, out, scratch, input) _Generic((array_pointer), \
+  uint8_t *: find_percentiles_u8_scratch, uint16_t *: find_percentiles_u16_scratch,                               \
+  int32_t *: find_percentiles_i32_scratch, float *: find_percentiles_f32_scratch,                                 \
+  double *: find_percentiles_f64_scratch)(array_pointer, array_size, qs, nq, out, scratch, input)
+
+/**
+ * @brief Macro to compute the covariance, correlation and regression of two arrays of samples.
+ *
+ * The kernel of pair.h matching the type of x (uint8_t, uint16_t, int32_t, float or double, const
+ * or not) is selected at compile time, y must have the same type.
+ *
+ * @param x          Pointer to the array of x samples.
+ * @param y          Pointer to the array of y samples.
+ * @param array_size Size of both arrays.
+ *
+ * @return Statistics of the pairs (see stats_pair_t).
+ */
+#define stats_pair_compute(x, y, array_size) _Generic((x),      \
+  uint8_t *: stats_pair_u8, const uint8_t *: stats_pair_u8,      \
+  uint16_t *: stats_pair_u16, const uint16_t *: stats_pair_u16,  \
+  int32_t *: stats_pair_i32, const int32_t *: stats_pair_i32,    \
+  float *: stats_pair_f32, const float *: stats_pair_f32,        \
+  double *: stats_pair_f64, const double *: stats_pair_f64)(x, y, array_size)
+
+/**
+ * @brief Macro to find several percentiles of an array of any supported sample type at once.
+ *
+ * The find_percentiles_* function of stats_typed.h matching the type of array_pointer is selected
+ * at compile time. The p1, p5, p25, p50, p75, p95 and p99 of an array, for example, cost a single
+ * histogram or multiselect pass instead of one find_kth call each.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param qs            Pointer to the quantiles to find, between 0 and 1.
+ * @param nq            Number of quantiles.
+ * @param out           Pointer to nq samples of the type of the array.
+ *
+ * @return nq, or 0 if the array is empty or the scratch copy cannot be allocated.
+ */
+#define find_percentiles(array_pointer, array_size, qs, nq, out) _Generic((array_pointer), \
+  uint8_t *: find_percentiles_u8, const uint8_t *: find_percentiles_u8,                    \
+  uint16_t *: find_percentiles_u16, const uint16_t *: find_percentiles_u16,                \
+  int32_t *: find_percentiles_i32, const int32_t *: find_percentiles_i32,                  \
+  float *: find_percentiles_f32, const float *: find_percentiles_f32,                      \
+  double *: find_percentiles_f64, const double *: find_percentiles_f64)(array_pointer, array_size, qs, nq, out)
+
+/**
+ * @brief Macro to compute the weighted statistics of an array of unsigned char values.
+ *
+ * The function of weighted.h matching the type of weights (uint32_t counts or double weights,
+ * const or not) is selected at compile time.
+ *
+ * @param samples    Pointer to the array of unsigned char values.
+ * @param weights    Pointer to the weight of every sample.
+ * @param array_size Size of both arrays.
+ *
+ * @return Weighted statistics of the array (see stats_weighted_t).
+ */
+#define stats_weighted_compute(samples, weights, array_size) _Generic((weights),  \
+  uint32_t *: stats_weighted_u32, const uint32_t *: stats_weighted_u32,            \
+  double *: stats_weighted_f64, const double *: stats_weighted_f64)(samples, weights, array_size)
+
+/**
+ * @brief Macro to find several weighted percentiles of an array of unsigned char values at once.
+ *
+ * The function of weighted.h matching the type of weights is selected at compile time.
+ *
+ * @param samples    Pointer to the array of unsigned char values.
+ * @param weights    Pointer to the weight of every sample.
+ * @param array_size Size of both arrays.
+ * @param qs         Pointer to the quantiles to find, between 0 and 1.
+ * @param nq         Number of quantiles.
+ * @param out        Pointer to nq unsigned char values.
+ *
+ * @return nq, or 0 if no sample has a positive weight.
+ */
+#define find_weighted_percentiles(samples, weights, array_size, qs, nq, out) _Generic((weights), \
+  uint32_t *: find_weighted_percentiles_u32, const uint32_t *: find_weighted_percentiles_u32,     \
+  double *: find_weighted_percentiles_f64, const double *: find_weighted_percentiles_f64)(samples, weights, array_size, qs, nq, out)
 
 #endif /* __STATS_H__ */
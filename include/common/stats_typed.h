@@ -0,0 +1,172 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file stats_typed.h
+ * @brief File containing the declaration of the typed statistics kernels.
+ *
+ * One kernel per sample type (stats_u8, stats_u16, stats_i32, stats_f32 and stats_f64) computes the
+ * count, minimum, maximum, range, sum, mean, variance, standard deviation, skewness and kurtosis of
+ * an array in a single pass. Every kernel is generated from
+ * the same template in stats_typed.c, so each type gets its own loop without widening the samples.
+ * stats_u8 also counts a histogram in the same pass and reports the mode.
+ * Use the stats_compute macro of stats.h to pick the kernel from the type of the array.
+ *
+ * The mode of the wider types cannot be streamed, it needs a sorted copy of the array, radix
+ * sorted for the integer types. It is left to the stats_mode_* functions, so callers that only
+ * want the moments never pay for the copy.
+ *
+ * The find_percentiles_* functions answer several quantiles of an array at once: from one histogram
+ * for 8-bit samples, and from one multiselect over a copy of the array (see sort_select) for the
+ * other types. Use the find_percentiles macro of stats.h to pick the function from the array type.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __STATS_TYPED_H__
+#define __STATS_TYPED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "scratch.h"
+
+/*
+ * Fields of every result type stats_<suffix>_t. Sums are exact 64-bit integers for the integer
+ * types and doubles for the floating point types.
+ */
+#define STATS_TYPED_FIELDS(type, sum_type)                                                      \
+  size_t count;               /* Number of samples */                                           \
+  type minimum;               /* Smallest sample, 0 if empty */                                 \
+  type maximum;               /* Largest sample, 0 if empty */                                  \
+  sum_type sum;               /* Sum of all samples */                                          \
+  double range;               /* Maximum minus minimum */                                       \
+  double mean;                /* Mean, 0 if empty */                                            \
+  double variance;            /* Population variance, 0 if empty */                             \
+  double stddev;              /* Population standard deviation */                               \
+  double skewness;            /* Population skewness, 0 if the variance is 0 */                 \
+  double kurtosis;            /* Population excess kurtosis, 0 if the variance is 0 */
+
+/* Declares the result type stats_<suffix>_t of a sample type wider than 8 bits */
+#define STATS_TYPED_RESULT(suffix, type, sum_type)                                              \
+typedef struct                                                                                  \
+{                                                                                               \
+  STATS_TYPED_FIELDS(type, sum_type)                                                            \
+} stats_##suffix##_t;
+
+/* Declares the kernel stats_<suffix> of a sample type and the functions that go with it */
+#define STATS_TYPED_DECLARE(suffix, type, sum_type)                                             \
+stats_##suffix##_t stats_##suffix(const type * array_pointer, size_t array_size);                \
+uint8_t stats_mode_##suffix(const type * array_pointer, size_t array_size, type * mode);         \
+uint8_t stats_mode_##suffix##_scratch(type * array_pointer, size_t array_size, type * mode,      \
+                                      stats_scratch_t * scratch, stats_input_t input);          \
+size_t find_percentiles_##suffix(const type * array_pointer, size_t array_size,                \
+                                 const double * qs, size_t nq, type * out);                     \
+size_t find_percentiles_##suffix##_scratch(type * array_pointer, size_t array_size,             \
+                                           const double * qs, size_t nq, type * out,            \
+                                           stats_scratch_t * scratch, stats_input_t input);
+
+/* Result of stats_u8, the histogram counted in the same pass also gives the mode */
+typedef struct
+{
+  STATS_TYPED_FIELDS(uint8_t, uint64_t)
+  uint8_t mode;               /* Most frequent sample, the smallest on ties, 0 if empty */
+} stats_u8_t;
+
+STATS_TYPED_RESULT(u16, uint16_t, uint64_t)
+STATS_TYPED_RESULT(i32, int32_t, int64_t)
+STATS_TYPED_RESULT(f32, float, double)
+STATS_TYPED_RESULT(f64, double, double)
+
+/**
+ * @brief Functions to compute the statistics of an array of samples of one type in a single pass.
+ *
+ * Each function takes in two input arguments: a pointer to an array of samples and the size of the
+ * array. The minimum and maximum of floating point arrays are unspecified if they contain NaN.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ *
+ * @return Statistics of the input array.
+ */
+
+/**
+ * @brief Functions to find the most frequent sample of an array, the smallest one on ties.
+ *
+ * 8-bit samples are counted in a histogram. The other types are sorted on a copy obtained from
+ * reserve_words, with a radix sort for the integer types, and the longest run of the copy wins.
+ * The mode of floating point arrays is unspecified if they contain NaN.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param mode          Pointer to the mode, only written when one is found.
+ *
+ * @return 1 if the mode was found, 0 if the array is empty or the copy cannot be allocated.
+ */
+
+/**
+ * @brief Functions to find the most frequent sample of an array with scratch memory from an arena.
+ *
+ * These functions find the same mode as stats_mode_* but take their temporary memory from the
+ * arena, at most SCRATCH_MODE_BYTES(array_size, sizeof(type)) bytes, or SCRATCH_SELECT_BYTES for
+ * 8-bit samples. With STATS_MAY_REORDER the array itself is sorted instead of a copy, which leaves
+ * it sorted and only needs the radix scratch of the integer types. 8-bit arrays are never reordered.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param mode          Pointer to the mode, only written when one is found.
+ * @param scratch       Pointer to the arena, every block taken is released before returning.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return 1 if the mode was found, 0 if the array is empty or the arena is too small.
+ */
+
+/**
+ * @brief Functions to find several percentiles of an array of samples of one type.
+ *
+ * Quantile q, clamped to [0, 1], is the sample of zero based rank round(q * (array_size - 1)), so
+ * 0 is the minimum and 1 the maximum. No value is interpolated. The input array is not modified,
+ * the functions other than find_percentiles_u8 select on a copy obtained from reserve_words.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param qs            Pointer to the quantiles to find, in any order.
+ * @param nq            Number of quantiles.
+ * @param out           Pointer to nq samples, out[i] receives quantile qs[i].
+ *
+ * @return nq, or 0 and every output set to 0 if the array is empty or the copy cannot be allocated.
+ */
+
+/**
+ * @brief Functions to find several percentiles of an array with scratch memory from an arena.
+ *
+ * These functions return the same percentiles as find_percentiles_* but take their temporary
+ * memory from the arena, at most SCRATCH_PERCENTILES_BYTES(array_size, sizeof(type), nq) bytes,
+ * or SCRATCH_SELECT_BYTES for 8-bit samples. With STATS_MAY_REORDER the selection runs on the
+ * array itself instead of a copy, which leaves the array reordered and only needs the ranks from
+ * the arena. 8-bit arrays are never reordered.
+ *
+ * @param array_pointer Pointer to the array of samples.
+ * @param array_size    Size of the array.
+ * @param qs            Pointer to the quantiles to find, in any order.
+ * @param nq            Number of quantiles.
+ * @param out           Pointer to nq samples, out[i] receives quantile qs[i].
+ * @param scratch       Pointer to the arena, every block taken is released before returning.
+ * @param input         STATS_MAY_REORDER to allow reordering the array, STATS_KEEP_INPUT otherwise.
+ *
+ * @return nq, or 0 and every output set to 0 if the array is empty or the arena is too small.
+ */
+STATS_TYPED_DECLARE(u8, uint8_t, uint64_t)
+STATS_TYPED_DECLARE(u16, uint16_t, uint64_t)
+STATS_TYPED_DECLARE(i32, int32_t, int64_t)
+STATS_TYPED_DECLARE(f32, float, double)
+STATS_TYPED_DECLARE(f64, double, double)
+
+#endif /* __STATS_TYPED_H__ */
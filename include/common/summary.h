@@ -0,0 +1,105 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file summary.h
+ * @brief File containing the declaration of the mergeable partial summary operations.
+ *
+ * A stats_summary_t computed over one shard of a data set can be merged with the summaries of the
+ * other shards in any order and grouping; the result is identical to the summary of the whole data
+ * set, including the exact median, because the histogram travels with the summary. Summaries can be
+ * serialized to a fixed size, platform independent byte layout to ship them between workers.
+ *
+ * Serialized layout, all integers little-endian:
+ *   offset 0    4 bytes   magic "STS1"
+ *   offset 4    8 bytes   count
+ *   offset 12   8 bytes   sum
+ *   offset 20   8 bytes   sum of squares
+ *   offset 28   1 byte    minimum
+ *   offset 29   1 byte    maximum
+ *   offset 30   2048 bytes histogram, 256 counters of 8 bytes
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __SUMMARY_H__
+#define __SUMMARY_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stats.h"
+
+/* Size in bytes of a serialized summary */
+#define SUMMARY_SERIALIZED_SIZE (30 + 8 * STATS_HISTOGRAM_BINS)
+
+/**
+ * @brief Function to reset a summary to the summary of an empty array.
+ *
+ * The empty summary is the identity of summary_merge.
+ *
+ * @param summary Pointer to the summary.
+ *
+ * @return void.
+ */
+void summary_init(stats_summary_t * summary);
+
+/**
+ * @brief Function to derive every field of a summary from its histogram.
+ *
+ * This function recomputes the count, sum, sum of squares, minimum, maximum, mean and median from
+ * the 256 histogram bins. It is used by compute_summary once the histogram has been filled, and by
+ * summary_merge.
+ *
+ * @param summary Pointer to the summary whose histogram is filled.
+ *
+ * @return void.
+ */
+void summary_from_histogram(stats_summary_t * summary);
+
+/**
+ * @brief Function to merge a partial summary into another one.
+ *
+ * After the call dst describes the samples of both summaries. The operation is exact, associative
+ * and commutative, so shard results can be reduced in any order.
+ *
+ * @param dst Pointer to the summary to update.
+ * @param src Pointer to the summary to merge, not modified.
+ *
+ * @return void.
+ */
+void summary_merge(stats_summary_t * dst, const stats_summary_t * src);
+
+/**
+ * @brief Function to serialize a summary to a byte buffer.
+ *
+ * @param summary     Pointer to the summary.
+ * @param buffer      Pointer to the destination buffer.
+ * @param buffer_size Size of the destination buffer, at least SUMMARY_SERIALIZED_SIZE.
+ *
+ * @return Number of bytes written, 0 if the buffer is too small.
+ */
+size_t summary_serialize(const stats_summary_t * summary, uint8_t * buffer, size_t buffer_size);
+
+/**
+ * @brief Function to read a summary back from a byte buffer.
+ *
+ * The stored count, sum, sum of squares, minimum and maximum are checked against the histogram, so
+ * a truncated or corrupted buffer is rejected instead of silently merged.
+ *
+ * @param buffer      Pointer to the serialized summary.
+ * @param buffer_size Size of the buffer.
+ * @param summary     Pointer to the summary to fill.
+ *
+ * @return Pointer to the filled summary, NULL if the buffer is not a valid summary.
+ */
+stats_summary_t * summary_deserialize(const uint8_t * buffer, size_t buffer_size, stats_summary_t * summary);
+
+#endif /* __SUMMARY_H__ */
@@ -0,0 +1,106 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file weighted.h
+ * @brief File containing the declaration of the weighted statistics of an array of unsigned char.
+ *
+ * Sample i of the array stands for weights[i] occurrences of its value, so aggregated data can be
+ * described without expanding it. One pass over both arrays builds a 256-bin histogram of weights,
+ * and the minimum, maximum, mean, variance, median and quantiles are read from it. The weights
+ * are either integer counts (the _u32 functions) or real weights (the _f64 functions), use the
+ * stats_weighted_compute and find_weighted_percentiles macros of stats.h to pick the function from
+ * the type of the weights. Samples whose weight is not positive, NaN included, are ignored.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __WEIGHTED_H__
+#define __WEIGHTED_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "scratch.h"
+
+/**
+ * @brief Weighted statistics of an array of unsigned char values.
+ *
+ * With integer counts every field matches the statistics of the expanded array: the median
+ * follows find_median, the mean and variance follow compute_summary without truncation.
+ */
+typedef struct
+{
+  size_t count;               /* Number of samples with a positive weight */
+  double total_weight;        /* Sum of the positive weights */
+  unsigned char minimum;      /* Smallest sample with a positive weight, 0 if none */
+  unsigned char maximum;      /* Largest sample with a positive weight, 0 if none */
+  unsigned char median;       /* Weighted median, 0 if none */
+  double mean;                /* Weighted mean, 0 if none */
+  double variance;            /* Weighted population variance, 0 if none */
+  double stddev;              /* Weighted population standard deviation */
+} stats_weighted_t;
+
+/* Declares the weighted functions of a weight type */
+#define WEIGHTED_DECLARE(suffix, weight_type)                                                   \
+stats_weighted_t stats_weighted_##suffix(const uint8_t * samples, const weight_type * weights,   \
+                                         size_t array_size);                                    \
+size_t find_weighted_percentiles_##suffix(const uint8_t * samples, const weight_type * weights, \
+                                          size_t array_size, const double * qs, size_t nq,      \
+                                          uint8_t * out);                                       \
+stats_weighted_t stats_weighted_##suffix##_scratch(const uint8_t * samples,                     \
+                                                   const weight_type * weights,                 \
+                                                   size_t array_size, stats_scratch_t * scratch); \
+size_t find_weighted_percentiles_##suffix##_scratch(const uint8_t * samples,                    \
+                                                    const weight_type * weights,                \
+                                                    size_t array_size, const double * qs,       \
+                                                    size_t nq, uint8_t * out,                   \
+                                                    stats_scratch_t * scratch);
+
+/**
+ * @brief Functions to compute the weighted statistics of an array in a single pass.
+ *
+ * @param samples    Pointer to the array of unsigned char values.
+ * @param weights    Pointer to the weight of every sample.
+ * @param array_size Size of both arrays.
+ *
+ * @return Weighted statistics of the array.
+ */
+
+/**
+ * @brief Functions to find several weighted percentiles of an array at once.
+ *
+ * Quantile q, clamped to [0, 1], is the smallest sample whose cumulative weight is larger than q
+ * times the total weight, or the maximum for q = 1. Every quantile is read from the same histogram.
+ *
+ * @param samples    Pointer to the array of unsigned char values.
+ * @param weights    Pointer to the weight of every sample.
+ * @param array_size Size of both arrays.
+ * @param qs         Pointer to the quantiles to find, in any order.
+ * @param nq         Number of quantiles.
+ * @param out        Pointer to nq values, out[i] receives quantile qs[i].
+ *
+ * @return nq, or 0 and every output set to 0 if no sample has a positive weight.
+ */
+
+/**
+ * @brief Functions to compute the weighted statistics and percentiles with scratch memory from an arena.
+ *
+ * The _scratch variants return the same results as the functions above but take the histogram of
+ * weights, SCRATCH_WEIGHTED_BYTES, from the arena instead of the stack and release it before
+ * returning. If the arena is too small the statistics are all zero, and the percentile variant
+ * returns 0 with every output set to 0.
+ *
+ * @param scratch Pointer to the arena.
+ */
+WEIGHTED_DECLARE(u32, uint32_t)
+WEIGHTED_DECLARE(f64, double)
+
+#endif /* __WEIGHTED_H__ */
@@ -0,0 +1,143 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file window.h
+ * @brief File containing the declaration of the sliding window statistics engine.
+ *
+ * A window keeps the last W samples of a stream of unsigned char values and updates their minimum,
+ * maximum, mean and median as every sample is pushed, instead of recomputing them over the whole
+ * window. The minimum and maximum come from monotonic deques in amortized O(1), the mean from a
+ * running sum in O(1), and the median from a histogram of the window with a cursor that moves by
+ * at most 256 bins per sample, which is O(1) with respect to W.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#ifndef __WINDOW_H__
+#define __WINDOW_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "stats.h"
+
+/**
+ * @brief State of a sliding window, created by window_create.
+ *
+ * The sample ring and both deques live in the same allocation as the structure. The deques hold
+ * positions in the sample ring, oldest first: the minimum deque has increasing values and the
+ * maximum deque decreasing values, so their fronts are the minimum and maximum of the window.
+ */
+typedef struct
+{
+  size_t width;                                 /* Number of samples kept, W */
+  size_t count;                                 /* Number of samples in the window, at most W */
+  size_t head;                                  /* Ring position of the oldest sample */
+  uint64_t sum;                                 /* Sum of the samples in the window */
+  unsigned char * samples;                      /* Ring of W samples */
+  size_t * min_deque;                           /* Ring of up to W positions */
+  size_t min_head;                              /* Front of the minimum deque */
+  size_t min_count;                             /* Length of the minimum deque */
+  size_t * max_deque;                           /* Ring of up to W positions */
+  size_t max_head;                              /* Front of the maximum deque */
+  size_t max_count;                             /* Length of the maximum deque */
+  unsigned char median;                         /* Value holding the lower middle rank */
+  size_t below;                                 /* Number of samples smaller than median */
+  size_t histogram[STATS_HISTOGRAM_BINS];       /* Occurrences of every value in the window */
+} stats_window_t;
+
+/**
+ * @brief Function to create an empty sliding window.
+ *
+ * @param width Number of samples kept in the window, W.
+ *
+ * @return Pointer to the window, or NULL if width is 0, too large to size the allocation or the
+ *         allocation fails.
+ */
+stats_window_t * window_create(size_t width);
+
+/**
+ * @brief Function to free a window created by window_create.
+ *
+ * @param window Pointer to the window, may be NULL.
+ *
+ * @return void.
+ */
+void window_destroy(stats_window_t * window);
+
+/**
+ * @brief Function to empty a window without freeing it.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return void.
+ */
+void window_reset(stats_window_t * window);
+
+/**
+ * @brief Function to add a sample to a window.
+ *
+ * Once the window holds W samples the oldest one is dropped. The statistics of the window are
+ * updated in amortized constant time.
+ *
+ * @param window Pointer to the window.
+ * @param sample Sample to add.
+ *
+ * @return void.
+ */
+void window_push(stats_window_t * window, unsigned char sample);
+
+/**
+ * @brief Function to get the number of samples in a window.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return Number of samples, at most the width of the window.
+ */
+size_t window_count(const stats_window_t * window);
+
+/**
+ * @brief Function to get the minimum of the samples in a window.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return Same value as find_minimum over the window, 0 if empty.
+ */
+unsigned char window_minimum(const stats_window_t * window);
+
+/**
+ * @brief Function to get the maximum of the samples in a window.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return Same value as find_maximum over the window, 0 if empty.
+ */
+unsigned char window_maximum(const stats_window_t * window);
+
+/**
+ * @brief Function to get the mean of the samples in a window.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return Same value as find_mean over the window, 0 if empty.
+ */
+unsigned char window_mean(const stats_window_t * window);
+
+/**
+ * @brief Function to get the median of the samples in a window.
+ *
+ * @param window Pointer to the window.
+ *
+ * @return Same value as find_median over the window, 0 if empty.
+ */
+unsigned char window_median(const stats_window_t * window);
+
+#endif /* __WINDOW_H__ */
@@ -12,7 +12,25 @@ ifeq ($(PLATFORM),MSP432)
 SOURCES = 	src/course1.c \
 			src/data.c \
 			src/stats.c \
+			src/stats_typed.c \
+			src/moments.c \
+			src/pair.c \
+			src/weighted.c \
+			src/window.c \
+			src/sketch.c \
+			src/selection.c \
+			src/scratch.c \
+			src/sort.c \
+			src/accum.c \
+			src/summary.c \
+			src/dataset.c \
+			src/robust.c \
+			src/kernels.c \
+			src/parallel.c \
+			src/kernels_dsp.c \
+			src/bench.c \
 			src/main.c \
+			src/memcopy.c \
 			src/memory.c \
 			src/interrupts_msp432p401r_gcc.c \
 			src/startup_msp432p401r_gcc.c \
@@ -25,7 +43,26 @@ else
 SOURCES = 	src/course1.c \
 			src/data.c \
 			src/stats.c \
+			src/stats_typed.c \
+			src/moments.c \
+			src/pair.c \
+			src/weighted.c \
+			src/window.c \
+			src/sketch.c \
+			src/selection.c \
+			src/scratch.c \
+			src/sort.c \
+			src/accum.c \
+			src/summary.c \
+			src/dataset.c \
+			src/robust.c \
+			src/kernels.c \
+			src/parallel.c \
+			src/kernels_dsp.c \
+			src/kernels_x86.c \
+			src/bench.c \
 			src/main.c \
+			src/memcopy.c \
 			src/memory.c
 
 INCLUDES = 	-Iinclude/common 
@@ -0,0 +1,158 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file accum.c
+ * @brief File containing the definition of the streaming statistics accumulator.
+ *
+ * Single samples use the Welford recurrence. Batches are first reduced to a histogram by the same
+ * engine as compute_summary, their mean and sum of squared differences are computed exactly from the 256 bins and the
+ * result is combined with the running state using the pairwise update of Chan et al., which is also
+ * what accum_merge uses.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "accum.h"
+#include "selection.h"
+
+static void accum_combine(stats_accum_t * accum, uint64_t count, double mean, double m2,
+                          unsigned char minimum, unsigned char maximum);
+
+/* Function definition*/
+void accum_init(stats_accum_t * accum)
+{
+  size_t value;
+
+  accum->count = 0;
+  accum->minimum = 255;
+  accum->maximum = 0;
+  accum->mean = 0.0;
+  accum->m2 = 0.0;
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    accum->histogram[value] = 0;
+  }
+}
+
+void accum_push(stats_accum_t * accum, unsigned char sample)
+{
+  double delta;
+
+  ++accum->count;
+  ++accum->histogram[sample];
+  accum->minimum = accum->minimum > sample ? sample : accum->minimum;
+  accum->maximum = accum->maximum < sample ? sample : accum->maximum;
+
+  delta = sample - accum->mean;
+  accum->mean += delta / (double)accum->count;
+  accum->m2 += delta * (sample - accum->mean);
+}
+
+void accum_push_batch(stats_accum_t * accum, const unsigned char * array_pointer, size_t array_size)
+{
+  size_t histogram[STATS_HISTOGRAM_BINS];
+  uint64_t sum_value = 0;
+  double mean;
+  double delta;
+  double m2 = 0.0;
+  size_t value;
+  unsigned char minimum = 255;
+  unsigned char maximum = 0;
+
+  if(array_pointer == NULL || 0 == array_size)
+  {
+    return;
+  }
+
+  select_histogram(array_pointer, array_size, histogram);
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    if(histogram[value] != 0)
+    {
+      minimum = minimum > value ? (unsigned char)value : minimum;
+      maximum = (unsigned char)value;
+      sum_value += (uint64_t)value * histogram[value];
+      accum->histogram[value] += histogram[value];
+    }
+  }
+
+  /* Two passes over the bins, so the batch variance does not suffer from cancellation */
+  mean = (double)sum_value / (double)array_size;
+  for(value = minimum; value <= maximum; ++value)
+  {
+    delta = value - mean;
+    m2 += delta * delta * (double)histogram[value];
+  }
+
+  accum_combine(accum, array_size, mean, m2, minimum, maximum);
+}
+
+void accum_merge(stats_accum_t * dst, const stats_accum_t * src)
+{
+  size_t value;
+
+  if(src->count == 0)
+  {
+    return;
+  }
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    dst->histogram[value] += src->histogram[value];
+  }
+
+  accum_combine(dst, src->count, src->mean, src->m2, src->minimum, src->maximum);
+}
+
+stats_accum_result_t accum_result(const stats_accum_t * accum)
+{
+  stats_accum_result_t result;
+
+  result.count = accum->count;
+  result.minimum = 0;
+  result.maximum = 0;
+  result.median = 0;
+  result.mean = 0.0;
+  result.variance = 0.0;
+
+  if(accum->count == 0)
+  {
+    return result;
+  }
+
+  result.minimum = accum->minimum;
+  result.maximum = accum->maximum;
+  result.mean = accum->mean;
+  result.variance = accum->m2 / (double)accum->count;
+
+  /* Nothing is below the minimum, the walk starts there */
+  result.median = select_median_from_u64(accum->histogram, accum->count, accum->minimum, 0);
+
+  return result;
+}
+
+static void accum_combine(stats_accum_t * accum, uint64_t count, double mean, double m2,
+                          unsigned char minimum, unsigned char maximum)
+{
+  double total = (double)(accum->count + count);
+  double delta = mean - accum->mean;
+
+  accum->m2 += m2 + delta * delta * (double)accum->count * (double)count / total;
+  accum->mean += delta * (double)count / total;
+  accum->count += count;
+  accum->minimum = accum->minimum > minimum ? minimum : accum->minimum;
+  accum->maximum = accum->maximum < maximum ? maximum : accum->maximum;
+}
@@ -0,0 +1,374 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file bench.c
+ * @brief File containing the throughput benchmarks.
+ *
+ * Every benchmark runs BENCH_REPEAT times over the same buffer and prints the throughput of the
+ * fastest run in GB/s.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#if defined (HOST)
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bench.h"
+#include "platform.h"
+#include "memory.h"
+#include "kernels.h"
+#include "memcopy.h"
+#include "parallel.h"
+#include "stats.h"
+#include "sort.h"
+
+#if defined (HOST)
+static double bench_seconds(void);
+static void bench_kernels(const uint8_t * set);
+static void bench_memcopy(const uint8_t * set);
+static void bench_parallel(const uint8_t * set);
+static void bench_sort(const uint8_t * set);
+static void bench_sort_parallel(const uint8_t * set);
+static size_t bench_next_threads(size_t threads, size_t max_threads);
+static int bench_compare_u32(const void * a, const void * b);
+
+/* Results are written here so the timed calls cannot be optimized away */
+static volatile uint64_t bench_sink;
+
+static double bench_seconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+
+static void bench_kernels(const uint8_t * set)
+{
+  const stats_kernels_t * list[KERNELS_MAX_TABLES];
+  const stats_kernels_t * kernels;
+  size_t count;
+  size_t i;
+  uint8_t op;
+  uint8_t run;
+  double start;
+  double best;
+  size_t histogram[256];
+  const char * names[4] = {"minimum", "maximum", "sum", "histogram"};
+
+  PRINTF("Kernel throughput over %u bytes (GB/s), selected: %s\n", BENCH_SIZE_B, kernels_get()->name);
+  count = kernels_available(list, KERNELS_MAX_TABLES);
+  for(op = 0; op < 4; ++op)
+  {
+    PRINTF("  %-10s", names[op]);
+    for(i = 0; i < count; ++i)
+    {
+      kernels = list[i];
+      best = 0.0;
+      for(run = 0; run < BENCH_REPEAT; ++run)
+      {
+        start = bench_seconds();
+        if(op == 0)
+        {
+          bench_sink = kernels->minimum(set, BENCH_SIZE_B);
+        }
+        else if(op == 1)
+        {
+          bench_sink = kernels->maximum(set, BENCH_SIZE_B);
+        }
+        else if(op == 2)
+        {
+          bench_sink = kernels->sum(set, BENCH_SIZE_B);
+        }
+        else
+        {
+          kernels->histogram(set, BENCH_SIZE_B, histogram);
+          bench_sink = histogram[0];
+        }
+        start = bench_seconds() - start;
+        best = (run == 0 || start < best) ? start : best;
+      }
+      PRINTF("  %s %7.2f", kernels->name, BENCH_SIZE_B / best * 1e-9);
+    }
+    PRINTF("\n");
+  }
+}
+
+static void bench_memcopy(const uint8_t * set)
+{
+  const memcopy_engine_t * list[MEMCOPY_MAX_ENGINES];
+  size_t count;
+  size_t i;
+  size_t offset;
+  uint8_t run;
+  uint8_t * copy;
+  double start;
+  double best;
+
+  copy = (uint8_t *)reserve_words(BENCH_SIZE_B / sizeof(int32_t));
+  if(! copy )
+  {
+    PRINTF("bench_memcopy(): allocation failed\n");
+    return;
+  }
+
+  /* The second row reads every word across two cache lines of the source */
+  PRINTF("Copy throughput over %u bytes (GB/s), selected: %s\n", BENCH_SIZE_B, memcopy_get()->name);
+  count = memcopy_available(list, MEMCOPY_MAX_ENGINES);
+  for(offset = 0; offset < 2; ++offset)
+  {
+    PRINTF("  %-10s", offset == 0 ? "aligned" : "offset 1");
+    for(i = 0; i < count; ++i)
+    {
+      best = 0.0;
+      for(run = 0; run < BENCH_REPEAT; ++run)
+      {
+        start = bench_seconds();
+        list[i]->copy(set + offset, copy, BENCH_SIZE_B - offset);
+        start = bench_seconds() - start;
+        best = (run == 0 || start < best) ? start : best;
+      }
+      bench_sink = copy[BENCH_SIZE_B / 2];
+      PRINTF("  %s %7.2f", list[i]->name, (BENCH_SIZE_B - offset) / best * 1e-9);
+    }
+    PRINTF("\n");
+  }
+
+  /* Non-temporal stores, used by my_memcopy and my_memset from the threshold on */
+  PRINTF("  %-10s", "stream");
+  for(offset = 0; offset < 2; ++offset)
+  {
+    best = 0.0;
+    for(run = 0; run < BENCH_REPEAT; ++run)
+    {
+      start = bench_seconds();
+      if(offset == 0)
+      {
+        memcopy_stream(set, copy, BENCH_SIZE_B);
+      }
+      else
+      {
+        memcopy_stream_fill(copy, BENCH_SIZE_B, (uint8_t)run);
+      }
+      start = bench_seconds() - start;
+      best = (run == 0 || start < best) ? start : best;
+    }
+    bench_sink = copy[BENCH_SIZE_B / 2];
+    PRINTF("  %s %7.2f", offset == 0 ? "copy" : "fill", BENCH_SIZE_B / best * 1e-9);
+  }
+  PRINTF(", threshold %zu bytes\n", memcopy_get_stream_threshold());
+
+  free_words((int32_t *)copy);
+}
+
+static void bench_parallel(const uint8_t * set)
+{
+  size_t threads;
+  size_t max_threads;
+  size_t previous_threads = parallel_get_configured_threads();
+  size_t histogram[256];
+  parallel_result_t result;
+  uint8_t run;
+  double start;
+  double best;
+
+  parallel_set_threads(0);
+  max_threads = parallel_get_threads();
+  PRINTF("Parallel min+max+sum+histogram over %u bytes (GB/s), %u online CPUs\n", BENCH_SIZE_B, (unsigned)max_threads);
+  for(threads = 1; threads <= max_threads; threads = bench_next_threads(threads, max_threads))
+  {
+    parallel_set_threads(threads);
+    best = 0.0;
+    for(run = 0; run < BENCH_REPEAT; ++run)
+    {
+      start = bench_seconds();
+      parallel_reduce(set, BENCH_SIZE_B,
+                      PARALLEL_OP_MINIMUM | PARALLEL_OP_MAXIMUM | PARALLEL_OP_SUM | PARALLEL_OP_HISTOGRAM,
+                      &result, histogram);
+      bench_sink = result.sum;
+      start = bench_seconds() - start;
+      best = (run == 0 || start < best) ? start : best;
+    }
+    PRINTF("  %3u threads %7.2f\n", (unsigned)threads, BENCH_SIZE_B / best * 1e-9);
+  }
+  parallel_set_threads(previous_threads);
+}
+
+static int bench_compare_u32(const void * a, const void * b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+static void bench_sort(const uint8_t * set)
+{
+  uint32_t * keys;
+  uint32_t * scratch;
+  const uint32_t * source = (const uint32_t *)set;
+  uint8_t * bytes;
+  uint8_t path;
+  uint8_t run;
+  size_t i;
+  double start;
+  double best;
+
+  keys = (uint32_t *)reserve_words(2 * BENCH_SORT_SIZE);
+  if(! keys )
+  {
+    PRINTF("bench_sort(): allocation failed\n");
+    return;
+  }
+  scratch = keys + BENCH_SORT_SIZE;
+  bytes = (uint8_t *)keys;
+
+  PRINTF("Sort of %u elements (ms)\n", BENCH_SORT_SIZE);
+  for(path = 0; path < 3; ++path)
+  {
+    best = 0.0;
+    for(run = 0; run < BENCH_REPEAT; ++run)
+    {
+      for(i = 0; i < BENCH_SORT_SIZE; ++i)
+      {
+        *(keys+i) = *(source+i);
+      }
+      start = bench_seconds();
+      switch(path)
+      {
+      case 0:
+        sort_array(bytes, BENCH_SORT_SIZE);
+        break;
+      case 1:
+        sort_radix_u32(keys, BENCH_SORT_SIZE, scratch, SORT_DESCENDING);
+        break;
+      default:
+        sort_generic(keys, BENCH_SORT_SIZE, sizeof(uint32_t), bench_compare_u32);
+        break;
+      }
+      start = bench_seconds() - start;
+      best = (run == 0 || start < best) ? start : best;
+    }
+    bench_sink = *keys;
+    PRINTF("  %-24s %9.2f\n", path == 0 ? "sort_array (u8 counting)" : path == 1 ? "sort_radix_u32" : "sort_generic (u32)",
+           best * 1e3);
+  }
+
+  free_words((int32_t *)keys);
+}
+
+static void bench_sort_parallel(const uint8_t * set)
+{
+  uint32_t * keys;
+  uint32_t * scratch;
+  uint8_t * bytes;
+  const uint32_t * source = (const uint32_t *)set;
+  size_t threads;
+  size_t max_threads;
+  size_t previous_threads = parallel_get_configured_threads();
+  size_t i;
+  uint8_t run;
+  double start;
+  double best_bytes;
+  double best_keys;
+
+  bytes = (uint8_t *)reserve_words(BENCH_SIZE_B / sizeof(int32_t) + 2 * BENCH_SORT_SIZE);
+  if(! bytes )
+  {
+    PRINTF("bench_sort_parallel(): allocation failed\n");
+    return;
+  }
+  keys = (uint32_t *)(bytes + BENCH_SIZE_B);
+  scratch = keys + BENCH_SORT_SIZE;
+
+  parallel_set_threads(0);
+  max_threads = parallel_get_threads();
+  PRINTF("Parallel sort (ms): sort_array_parallel of %u bytes, sort_generic_parallel of %u u32\n",
+         BENCH_SIZE_B, BENCH_SORT_SIZE);
+  for(threads = 1; threads <= max_threads; threads = bench_next_threads(threads, max_threads))
+  {
+    parallel_set_threads(threads);
+    best_bytes = 0.0;
+    best_keys = 0.0;
+    for(run = 0; run < BENCH_REPEAT; ++run)
+    {
+      for(i = 0; i < BENCH_SIZE_B; ++i)
+      {
+        *(bytes+i) = *(set+i);
+      }
+      start = bench_seconds();
+      sort_array_parallel(bytes, BENCH_SIZE_B);
+      start = bench_seconds() - start;
+      best_bytes = (run == 0 || start < best_bytes) ? start : best_bytes;
+
+      for(i = 0; i < BENCH_SORT_SIZE; ++i)
+      {
+        *(keys+i) = *(source+i);
+      }
+      start = bench_seconds();
+      sort_generic_parallel(keys, BENCH_SORT_SIZE, sizeof(uint32_t), bench_compare_u32, scratch);
+      start = bench_seconds() - start;
+      best_keys = (run == 0 || start < best_keys) ? start : best_keys;
+    }
+    bench_sink = *bytes + *keys;
+    PRINTF("  %3u threads %9.2f %9.2f\n", (unsigned)threads, best_bytes * 1e3, best_keys * 1e3);
+  }
+  parallel_set_threads(previous_threads);
+
+  free_words((int32_t *)bytes);
+}
+
+/* Doubles the thread count and ends on max_threads even when it is not a power of two */
+static size_t bench_next_threads(size_t threads, size_t max_threads)
+{
+  if(threads < max_threads && threads * 2 > max_threads)
+  {
+    return max_threads;
+  }
+  return threads * 2;
+}
+#endif
+
+/* Function definition*/
+void bench(void)
+{
+#if defined (HOST)
+  uint8_t * set;
+  uint32_t seed = 0x12345678u;
+  size_t i;
+
+  set = (uint8_t *)reserve_words(BENCH_SIZE_B / sizeof(int32_t));
+  if(! set )
+  {
+    PRINTF("bench(): allocation failed\n");
+    return;
+  }
+
+  for(i = 0; i < BENCH_SIZE_B; ++i)
+  {
+    seed = seed * 1103515245u + 12345u;
+    set[i] = (uint8_t)(seed >> 16);
+  }
+
+  bench_kernels(set);
+  bench_memcopy(set);
+  bench_parallel(set);
+  bench_sort(set);
+  bench_sort_parallel(set);
+
+  free_words((int32_t *)set);
+#endif
+}
@@ -18,11 +18,59 @@
  */
 
 #include <stdint.h>
+#include <math.h>
 #include "course1.h"
 #include "platform.h"
 #include "memory.h"
+#include "memcopy.h"
 #include "data.h"
 #include "stats.h"
+#include "kernels.h"
+#include "accum.h"
+#include "summary.h"
+#include "parallel.h"
+#include "sort.h"
+#include "window.h"
+#include "sketch.h"
+#include "dataset.h"
+#include "robust.h"
+
+static void fill_random(uint8_t * ptr, size_t length, uint32_t seed);
+static int compare_u32(const void * a, const void * b);
+static int compare_i32(const void * a, const void * b);
+static int compare_u32_descending(const void * a, const void * b);
+
+static void fill_random(uint8_t * ptr, size_t length, uint32_t seed)
+{
+  size_t i;
+
+  for (i = 0; i < length; i++)
+  {
+    seed = seed * 1103515245u + 12345u;
+    ptr[i] = (uint8_t)(seed >> 16);
+  }
+}
+
+static int compare_u32(const void * a, const void * b)
+{
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+
+  return (x > y) - (x < y);
+}
+
+static int compare_u32_descending(const void * a, const void * b)
+{
+  return compare_u32(b, a);
+}
+
+static int compare_i32(const void * a, const void * b)
+{
+  int32_t x = *(const int32_t *)a;
+  int32_t y = *(const int32_t *)b;
+
+  return (x > y) - (x < y);
+}
 
 int8_t test_data1() {
   uint8_t * ptr;
@@ -321,6 +369,2033 @@ int8_t test_reverse()
   return ret;
 }
 
+int8_t test_kth()
+{
+  uint16_t i;
+  uint16_t k;
+  uint16_t below;
+  uint16_t equal;
+  uint16_t lengths[2] = {STATS_SMALL_SIZE, STATS_SET_SIZE_B};
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t value;
+  uint8_t length;
+
+  PRINTF("test_kth()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  for (length = 0; length < 2; length++)
+  {
+    fill_random(set, lengths[length], 0xC0FFEE + length);
+
+    for (k = 0; k < lengths[length]; k++)
+    {
+      value = find_kth(set, lengths[length], k);
+      below = 0;
+      equal = 0;
+      for (i = 0; i < lengths[length]; i++)
+      {
+        below += (set[i] < value);
+        equal += (set[i] == value);
+      }
+      if (equal == 0 || below > k || below + equal <= k)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    value = (find_kth(set, lengths[length], (lengths[length] - 1) / 2) +
+             find_kth(set, lengths[length], lengths[length] / 2)) / 2;
+    if (find_median(set, lengths[length]) != value)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Sorted input with a single distinct outlier */
+  for (i = 0; i < STATS_SMALL_SIZE; i++)
+  {
+    set[i] = (uint8_t)i;
+  }
+  if (find_median(set, STATS_SMALL_SIZE) != STATS_SMALL_SIZE / 2 ||
+      find_kth(set, STATS_SMALL_SIZE, STATS_SMALL_SIZE) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_summary()
+{
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t minimum = 255;
+  uint8_t maximum = 0;
+  uint32_t sum = 0;
+  size_t counted = 0;
+  stats_summary_t summary;
+
+  PRINTF("test_summary()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  fill_random(set, STATS_SET_SIZE_B, 0xBEEF);
+  summary = compute_summary(set, STATS_SET_SIZE_B);
+
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    minimum = set[i] < minimum ? set[i] : minimum;
+    maximum = set[i] > maximum ? set[i] : maximum;
+    sum += set[i];
+  }
+  for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+  {
+    counted += summary.histogram[i];
+  }
+
+  if (summary.count != STATS_SET_SIZE_B || counted != STATS_SET_SIZE_B ||
+      summary.minimum != minimum || summary.maximum != maximum ||
+      summary.sum != sum || summary.mean != sum / STATS_SET_SIZE_B ||
+      summary.median != find_median(set, STATS_SET_SIZE_B))
+  {
+    ret = TEST_ERROR;
+  }
+
+  summary = compute_summary(set, 0);
+  if (summary.count != 0 || summary.sum != 0 || summary.median != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_kernels()
+{
+  size_t offset;
+  size_t length;
+  size_t count;
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  const uint8_t * ptr;
+  const stats_kernels_t * list[KERNELS_MAX_TABLES];
+  size_t histogram[STATS_HISTOGRAM_BINS];
+  size_t reference[STATS_HISTOGRAM_BINS];
+  uint16_t value;
+
+  PRINTF("test_kernels()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  fill_random(set, STATS_SET_SIZE_B, 0xD15C);
+  count = kernels_available(list, KERNELS_MAX_TABLES);
+
+  for (i = 0; i < count; i++)
+  {
+    #ifdef VERBOSE
+    PRINTF("  kernels: %s\n", list[i]->name);
+    #endif
+    for (offset = 0; offset < 64; offset++)
+    {
+      for (length = 0; length + offset <= STATS_SET_SIZE_B; length += 1 + length / 4)
+      {
+        ptr = set + offset;
+        if (list[i]->minimum(ptr, length) != kernels_scalar.minimum(ptr, length) ||
+            list[i]->maximum(ptr, length) != kernels_scalar.maximum(ptr, length) ||
+            list[i]->sum(ptr, length) != kernels_scalar.sum(ptr, length))
+        {
+          ret = TEST_ERROR;
+        }
+        list[i]->histogram(ptr, length, histogram);
+        kernels_scalar.histogram(ptr, length, reference);
+        for (value = 0; value < STATS_HISTOGRAM_BINS; value++)
+        {
+          if (histogram[value] != reference[value])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  /* Extremes must survive the vector reductions */
+  my_memset(set, STATS_SET_SIZE_B, 0x80);
+  set[STATS_SET_SIZE_B - 1] = 0;
+  set[STATS_SET_SIZE_B / 2] = 255;
+  for (i = 0; i < count; i++)
+  {
+    if (list[i]->minimum(set, STATS_SET_SIZE_B) != 0 ||
+        list[i]->maximum(set, STATS_SET_SIZE_B) != 255)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_accum()
+{
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  double variance = 0.0;
+  double delta;
+  stats_accum_t single;
+  stats_accum_t batch;
+  stats_accum_result_t result;
+  stats_summary_t summary;
+
+  PRINTF("test_accum()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  fill_random(set, STATS_SET_SIZE_B, 0xACC);
+  summary = compute_summary(set, STATS_SET_SIZE_B);
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    delta = set[i] - (double)summary.sum / STATS_SET_SIZE_B;
+    variance += delta * delta / STATS_SET_SIZE_B;
+  }
+
+  /* First part one sample at a time, the rest in two uneven batches */
+  accum_init(&single);
+  accum_init(&batch);
+  for (i = 0; i < STATS_SMALL_SIZE; i++)
+  {
+    accum_push(&single, set[i]);
+  }
+  accum_push_batch(&batch, set + STATS_SMALL_SIZE, 100);
+  accum_push_batch(&batch, set + STATS_SMALL_SIZE + 100, STATS_SET_SIZE_B - STATS_SMALL_SIZE - 100);
+  accum_merge(&single, &batch);
+  result = accum_result(&single);
+
+  if (result.count != STATS_SET_SIZE_B || result.minimum != summary.minimum ||
+      result.maximum != summary.maximum || result.median != summary.median ||
+      (uint8_t)result.mean != summary.mean ||
+      result.variance - variance > 1e-9 || variance - result.variance > 1e-9)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+  {
+    if (single.histogram[i] != summary.histogram[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  accum_init(&single);
+  result = accum_result(&single);
+  if (result.count != 0 || result.minimum != 0 || result.variance != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_summary_merge()
+{
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t buffer[SUMMARY_SERIALIZED_SIZE];
+  size_t shard_size[3] = {1, 400, STATS_SET_SIZE_B - 401};
+  stats_summary_t whole;
+  stats_summary_t shard[3];
+  stats_summary_t forward;
+  stats_summary_t backward;
+
+  PRINTF("test_summary_merge()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  fill_random(set, STATS_SET_SIZE_B, 0x5EED);
+  whole = compute_summary(set, STATS_SET_SIZE_B);
+  shard[0] = compute_summary(set, shard_size[0]);
+  shard[1] = compute_summary(set + shard_size[0], shard_size[1]);
+  shard[2] = compute_summary(set + shard_size[0] + shard_size[1], shard_size[2]);
+
+  /* (0 + 1) + 2 */
+  summary_init(&forward);
+  summary_merge(&forward, &shard[0]);
+  summary_merge(&forward, &shard[1]);
+  summary_merge(&forward, &shard[2]);
+
+  /* 2 + (1 + 0), shipping shard 1 through a buffer */
+  if (summary_serialize(&shard[1], buffer, sizeof(buffer)) != SUMMARY_SERIALIZED_SIZE ||
+      summary_deserialize(buffer, sizeof(buffer), &backward) == NULL)
+  {
+    ret = TEST_ERROR;
+  }
+  summary_merge(&backward, &shard[0]);
+  summary_merge(&shard[2], &backward);
+  backward = shard[2];
+
+  if (forward.count != whole.count || backward.count != whole.count ||
+      forward.sum != whole.sum || backward.sum != whole.sum ||
+      forward.sum_squares != whole.sum_squares || backward.sum_squares != whole.sum_squares ||
+      forward.minimum != whole.minimum || backward.minimum != whole.minimum ||
+      forward.maximum != whole.maximum || backward.maximum != whole.maximum ||
+      forward.mean != whole.mean || backward.mean != whole.mean ||
+      forward.median != whole.median || backward.median != whole.median)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+  {
+    if (forward.histogram[i] != whole.histogram[i] || backward.histogram[i] != whole.histogram[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* A flipped histogram byte no longer matches the stored sums */
+  buffer[SUMMARY_SERIALIZED_SIZE - 8] ^= 1;
+  if (summary_deserialize(buffer, sizeof(buffer), &backward) != NULL ||
+      summary_deserialize(buffer, SUMMARY_SERIALIZED_SIZE - 1, &backward) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_parallel()
+{
+  size_t threads;
+  size_t previous_threads;
+  size_t previous_threshold;
+  uint16_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  size_t histogram[STATS_HISTOGRAM_BINS];
+  size_t reference[STATS_HISTOGRAM_BINS];
+  parallel_result_t result;
+
+  PRINTF("test_parallel()\n");
+  set = (uint8_t*)reserve_words(PARALLEL_SET_SIZE_B / sizeof(int32_t) + 1);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  fill_random(set, PARALLEL_SET_SIZE_B, 0x7EAD);
+  set[PARALLEL_SET_SIZE_B - 1] = 0;
+  set[PARALLEL_SET_SIZE_B / 3] = 255;
+  kernels_scalar.histogram(set, PARALLEL_SET_SIZE_B, reference);
+
+  previous_threads = parallel_get_configured_threads();
+  previous_threshold = parallel_get_threshold();
+  parallel_set_threshold(0);
+
+  for (threads = 1; threads <= 8; threads++)
+  {
+    parallel_set_threads(threads);
+    parallel_reduce(set, PARALLEL_SET_SIZE_B,
+                    PARALLEL_OP_MINIMUM | PARALLEL_OP_MAXIMUM | PARALLEL_OP_SUM | PARALLEL_OP_HISTOGRAM,
+                    &result, histogram);
+    if (result.minimum != 0 || result.maximum != 255 ||
+        result.sum != kernels_scalar.sum(set, PARALLEL_SET_SIZE_B))
+    {
+      ret = TEST_ERROR;
+    }
+    for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+    {
+      if (histogram[i] != reference[i])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    if (find_mean(set, PARALLEL_SET_SIZE_B) != result.sum / PARALLEL_SET_SIZE_B)
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* Without the histogram the kernels run on every chunk instead */
+    parallel_reduce(set, PARALLEL_SET_SIZE_B, PARALLEL_OP_MINIMUM | PARALLEL_OP_MAXIMUM | PARALLEL_OP_SUM,
+                    &result, NULL);
+    if (result.minimum != 0 || result.maximum != 255 ||
+        result.sum != kernels_scalar.sum(set, PARALLEL_SET_SIZE_B))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* The serial path, with and without the histogram, and on an array of one value */
+  parallel_set_threshold(SIZE_MAX);
+  parallel_reduce(set, PARALLEL_SET_SIZE_B, PARALLEL_OP_MAXIMUM | PARALLEL_OP_SUM | PARALLEL_OP_HISTOGRAM,
+                  &result, histogram);
+  if (result.minimum != 255 || result.maximum != 255 || result.sum != kernels_scalar.sum(set, PARALLEL_SET_SIZE_B) ||
+      histogram[0] != reference[0])
+  {
+    ret = TEST_ERROR;
+  }
+  parallel_reduce(set + PARALLEL_SET_SIZE_B - 1, 1, PARALLEL_OP_MINIMUM | PARALLEL_OP_MAXIMUM | PARALLEL_OP_SUM,
+                  &result, NULL);
+  if (result.minimum != 0 || result.maximum != 0 || result.sum != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  parallel_reduce(set + PARALLEL_SET_SIZE_B / 3, 1, PARALLEL_OP_MINIMUM | PARALLEL_OP_HISTOGRAM, &result, histogram);
+  if (result.minimum != 255 || result.maximum != 0 || histogram[255] != 1)
+  {
+    ret = TEST_ERROR;
+  }
+
+  parallel_set_threads(previous_threads);
+  parallel_set_threshold(previous_threshold);
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_sort()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint32_t * set;
+  uint32_t * expected;
+  uint32_t * scratch;
+  uint8_t * bytes;
+  uint16_t * halves;
+  size_t histogram[STATS_HISTOGRAM_BINS];
+  stats_summary_t summary;
+
+  PRINTF("test_sort()\n");
+  set = (uint32_t*)reserve_words(3 * SORT_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  expected = set + SORT_SET_SIZE_W;
+  scratch = expected + SORT_SET_SIZE_W;
+
+  /* Counting sort, descending and a permutation of the input */
+  bytes = (uint8_t*)set;
+  fill_random(bytes, STATS_SET_SIZE_B, 0x5027);
+  summary = compute_summary(bytes, STATS_SET_SIZE_B);
+  sort_array(bytes, STATS_SET_SIZE_B);
+  for (i = 1; i < STATS_SET_SIZE_B; i++)
+  {
+    if (bytes[i - 1] < bytes[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  kernels_scalar.histogram(bytes, STATS_SET_SIZE_B, histogram);
+  for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+  {
+    if (histogram[i] != summary.histogram[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Radix sorts against the introsort, both orders */
+  fill_random((uint8_t*)set, SORT_SET_SIZE_W * sizeof(uint32_t), 0x50C7);
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    expected[i] = set[i];
+  }
+  sort_generic(expected, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32);
+  sort_radix_u32(set, SORT_SET_SIZE_W, scratch, SORT_DESCENDING);
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    if (set[i] != expected[SORT_SET_SIZE_W - 1 - i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  fill_random((uint8_t*)set, SORT_SET_SIZE_W * sizeof(uint32_t), 0x51C7);
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    expected[i] = set[i];
+  }
+  sort_generic(expected, SORT_SET_SIZE_W, sizeof(int32_t), compare_i32);
+  sort_radix_i32((int32_t*)set, SORT_SET_SIZE_W, (int32_t*)scratch, SORT_ASCENDING);
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    if (set[i] != expected[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  halves = (uint16_t*)set;
+  fill_random((uint8_t*)halves, SORT_SET_SIZE_W * sizeof(uint16_t), 0x5016);
+  sort_radix_u16(halves, SORT_SET_SIZE_W, (uint16_t*)scratch, SORT_ASCENDING);
+  for (i = 1; i < SORT_SET_SIZE_W; i++)
+  {
+    if (halves[i - 1] > halves[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Introsort on inputs that defeat a plain quicksort: sorted, reversed and constant */
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    set[i] = (uint32_t)(SORT_SET_SIZE_W - i);
+    expected[i] = 7;
+  }
+  sort_generic(set, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32);
+  sort_generic(set, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32);
+  sort_generic(expected, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32);
+  for (i = 0; i < SORT_SET_SIZE_W; i++)
+  {
+    if (set[i] != i + 1 || expected[i] != 7)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_sort_parallel()
+{
+  size_t threads;
+  size_t previous_threads;
+  size_t previous_threshold;
+  size_t i;
+  uint8_t pass;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * bytes;
+  uint8_t * expected_bytes;
+  uint32_t * set;
+  uint32_t * expected;
+  uint32_t * scratch;
+
+  PRINTF("test_sort_parallel()\n");
+  bytes = (uint8_t*)reserve_words(2 * (PARALLEL_SET_SIZE_B / sizeof(int32_t) + 1));
+  set = (uint32_t*)reserve_words(3 * PARALLEL_SORT_SIZE_W);
+  if (! bytes || ! set )
+  {
+    free_words( (int32_t*)bytes );
+    free_words( (int32_t*)set );
+    return TEST_ERROR;
+  }
+  expected_bytes = bytes + PARALLEL_SET_SIZE_B;
+  expected = set + PARALLEL_SORT_SIZE_W;
+  scratch = expected + PARALLEL_SORT_SIZE_W;
+
+  previous_threads = parallel_get_configured_threads();
+  previous_threshold = parallel_get_threshold();
+  parallel_set_threshold(0);
+
+  fill_random(expected_bytes, PARALLEL_SET_SIZE_B, 0x5A7E);
+  sort_array(expected_bytes, PARALLEL_SET_SIZE_B);
+
+  for (threads = 1; threads <= 8; threads++)
+  {
+    parallel_set_threads(threads);
+
+    fill_random(bytes, PARALLEL_SET_SIZE_B, 0x5A7E);
+    sort_array_parallel(bytes, PARALLEL_SET_SIZE_B);
+    for (i = 0; i < PARALLEL_SET_SIZE_B; i++)
+    {
+      if (bytes[i] != expected_bytes[i])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    /* Random keys, then keys with many duplicates to exercise the merge path ties */
+    for (pass = 0; pass < 2; pass++)
+    {
+      fill_random((uint8_t*)set, PARALLEL_SORT_SIZE_W * sizeof(uint32_t), 0x5A7F + (uint32_t)threads);
+      for (i = 0; i < PARALLEL_SORT_SIZE_W; i++)
+      {
+        set[i] = pass ? set[i] & 0xF : set[i];
+        expected[i] = set[i];
+      }
+      sort_generic(expected, PARALLEL_SORT_SIZE_W, sizeof(uint32_t), compare_u32_descending);
+      sort_generic_parallel(set, PARALLEL_SORT_SIZE_W, sizeof(uint32_t), compare_u32_descending, scratch);
+      for (i = 0; i < PARALLEL_SORT_SIZE_W; i++)
+      {
+        if (set[i] != expected[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  parallel_set_threads(previous_threads);
+  parallel_set_threshold(previous_threshold);
+
+  free_words( (int32_t*)set );
+  free_words( (int32_t*)bytes );
+  return ret;
+}
+
+int8_t test_typed()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * bytes;
+  uint16_t * adc;
+  int32_t * signed_set;
+  float * floats;
+  double * doubles;
+  uint64_t sum = 0;
+  int64_t signed_sum = 0;
+  stats_u8_t result_u8;
+  stats_u16_t result_u16;
+  stats_i32_t result_i32;
+  stats_f32_t result_f32;
+  stats_f64_t result_f64;
+  uint8_t mode_u8;
+  uint16_t mode_u16;
+  int32_t mode_i32;
+  float mode_f32;
+  double mode_f64;
+
+  PRINTF("test_typed()\n");
+  bytes = (uint8_t*)reserve_words(TYPED_SET_SIZE * (sizeof(double) + sizeof(float) + sizeof(int32_t) + sizeof(uint16_t)) / sizeof(int32_t));
+  if (! bytes )
+  {
+    return TEST_ERROR;
+  }
+  doubles = (double*)bytes;
+  floats = (float*)(doubles + TYPED_SET_SIZE);
+  signed_set = (int32_t*)(floats + TYPED_SET_SIZE);
+  adc = (uint16_t*)(signed_set + TYPED_SET_SIZE);
+
+  /* 12-bit ADC samples with one full scale spike */
+  fill_random((uint8_t*)adc, TYPED_SET_SIZE * sizeof(uint16_t), 0x7123);
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    adc[i] = (uint16_t)((adc[i] & 0x0FFF) | 1);
+  }
+  adc[TYPED_SET_SIZE / 2] = 0x0FFF;
+  adc[7] = 0;
+  for (i = 100; i < 106; i++)
+  {
+    adc[i] = 0x0800;
+  }
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    sum += adc[i];
+  }
+  result_u16 = stats_compute(adc, TYPED_SET_SIZE);
+  if (result_u16.count != TYPED_SET_SIZE || result_u16.minimum != 0 || result_u16.maximum != 0x0FFF ||
+      result_u16.sum != sum || result_u16.mean != (double)sum / TYPED_SET_SIZE ||
+      stats_mode(adc, TYPED_SET_SIZE, &mode_u16) != 1 || mode_u16 != 0x0800)
+  {
+    ret = TEST_ERROR;
+  }
+
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    signed_set[i] = (int32_t)(i * 7919u % 2001u) - 1000;
+    signed_sum += signed_set[i];
+  }
+  signed_set[3] = INT32_MIN;
+  signed_sum += (int64_t)INT32_MIN - ((int32_t)(3u * 7919u % 2001u) - 1000);
+  result_i32 = stats_compute((const int32_t*)signed_set, TYPED_SET_SIZE);
+  /* Every sample is distinct, the tie goes to the smallest one */
+  if (result_i32.minimum != INT32_MIN || result_i32.maximum != 1000 || result_i32.sum != signed_sum ||
+      stats_mode((const int32_t*)signed_set, TYPED_SET_SIZE, &mode_i32) != 1 || mode_i32 != INT32_MIN ||
+      signed_set[3] != INT32_MIN)
+  {
+    ret = TEST_ERROR;
+  }
+
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    floats[i] = (float)i * 0.5f - 100.0f;
+    doubles[i] = (double)i * 0.25 + 3.0;
+  }
+  result_f32 = stats_compute(floats, TYPED_SET_SIZE);
+  result_f64 = stats_compute(doubles, TYPED_SET_SIZE);
+  if (result_f32.minimum != -100.0f || result_f32.maximum != (float)(TYPED_SET_SIZE - 1) * 0.5f - 100.0f ||
+      result_f32.mean != (TYPED_SET_SIZE - 1) * 0.25 - 100.0 ||
+      result_f64.minimum != 3.0 || result_f64.mean != (TYPED_SET_SIZE - 1) * 0.125 + 3.0 ||
+      stats_mode(floats, TYPED_SET_SIZE, &mode_f32) != 1 || mode_f32 != -100.0f ||
+      stats_mode(doubles, TYPED_SET_SIZE, &mode_f64) != 1 || mode_f64 != 3.0 ||
+      stats_mode(doubles, 0, &mode_f64) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* The byte kernel agrees with the reduction engine */
+  fill_random(bytes, STATS_SET_SIZE_B, 0x7124);
+  result_u8 = stats_compute(bytes, STATS_SET_SIZE_B);
+  if (result_u8.minimum != find_minimum(bytes, STATS_SET_SIZE_B) ||
+      result_u8.maximum != find_maximum(bytes, STATS_SET_SIZE_B) ||
+      (unsigned char)result_u8.mean != find_mean(bytes, STATS_SET_SIZE_B) ||
+      result_u8.mode != compute_summary(bytes, STATS_SET_SIZE_B).mode ||
+      stats_mode(bytes, STATS_SET_SIZE_B, &mode_u8) != 1 || mode_u8 != result_u8.mode)
+  {
+    ret = TEST_ERROR;
+  }
+
+  result_u8 = stats_u8(bytes, 0);
+  if (result_u8.count != 0 || result_u8.mean != 0.0 || result_u8.mode != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)bytes );
+  return ret;
+}
+
+int8_t test_window()
+{
+  size_t i;
+  size_t first;
+  size_t width;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  stats_window_t * window;
+
+  PRINTF("test_window()\n");
+  set = (uint8_t*)reserve_words(STATS_SET_SIZE_W);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  /* Random samples, then a descending and an ascending ramp that stress the deques */
+  fill_random(set, STATS_SET_SIZE_B, 0x3141);
+  for (i = 0; i < 200; i++)
+  {
+    set[500 + i] = (uint8_t)(255 - i);
+    set[700 + i] = (uint8_t)(i / 2);
+  }
+
+  for (width = 1; width <= 64; width += 21)
+  {
+    window = window_create(width);
+    if (! window )
+    {
+      ret = TEST_ERROR;
+      break;
+    }
+    for (i = 0; i < STATS_SET_SIZE_B; i++)
+    {
+      window_push(window, set[i]);
+      first = i + 1 > width ? i + 1 - width : 0;
+      if (window_count(window) != i + 1 - first ||
+          window_minimum(window) != find_minimum(set + first, i + 1 - first) ||
+          window_maximum(window) != find_maximum(set + first, i + 1 - first) ||
+          window_mean(window) != find_mean(set + first, i + 1 - first) ||
+          window_median(window) != find_median(set + first, i + 1 - first))
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    window_reset(window);
+    if (window_count(window) != 0 || window_median(window) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    window_destroy(window);
+  }
+
+  if (window_create(0) != NULL || window_create(SIZE_MAX) != NULL || window_create(SIZE_MAX / 8) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_sketch()
+{
+  size_t i;
+  size_t q;
+  int8_t ret = TEST_NO_ERROR;
+  double value;
+  double tolerance = SKETCH_TEST_ERROR * SKETCH_TEST_SIZE;
+  const double quantiles[4] = {0.5, 0.95, 0.99, 0.01};
+  stats_sketch_t * sketch;
+  stats_sketch_t * shard;
+
+  PRINTF("test_sketch()\n");
+  sketch = (stats_sketch_t*)reserve_words(2 * sizeof(stats_sketch_t) / sizeof(int32_t) + 2);
+  if (! sketch )
+  {
+    return TEST_ERROR;
+  }
+  shard = sketch + 1;
+  sketch_init(sketch);
+  sketch_init(shard);
+
+  if (sketch_quantile(sketch, 0.5) != 0.0 || sketch_cdf(sketch, 1.0) != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* A permutation of 0..N-1 split over two shards, the rank of value v is v */
+  for (i = 0; i < SKETCH_TEST_SIZE; i++)
+  {
+    value = (double)((i * 7919u) % SKETCH_TEST_SIZE);
+    sketch_insert(i % 3 ? sketch : shard, value);
+  }
+  value = 0.0;
+  sketch_insert(sketch, value / value);
+  sketch_merge(sketch, shard);
+
+  if (sketch->count != SKETCH_TEST_SIZE || sketch->minimum != 0.0 ||
+      sketch->maximum != SKETCH_TEST_SIZE - 1 || sketch->stored > SKETCH_CAPACITY)
+  {
+    ret = TEST_ERROR;
+  }
+  for (q = 0; q < 4; q++)
+  {
+    value = sketch_quantile(sketch, quantiles[q]);
+    if (value < quantiles[q] * SKETCH_TEST_SIZE - tolerance ||
+        value > quantiles[q] * SKETCH_TEST_SIZE + tolerance)
+    {
+      ret = TEST_ERROR;
+    }
+    value = sketch_cdf(sketch, quantiles[q] * SKETCH_TEST_SIZE);
+    if (value < quantiles[q] - SKETCH_TEST_ERROR || value > quantiles[q] + SKETCH_TEST_ERROR)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  if (sketch_quantile(sketch, 0.0) != 0.0 || sketch_quantile(sketch, 1.0) != SKETCH_TEST_SIZE - 1 ||
+      sketch_cdf(sketch, SKETCH_TEST_SIZE) != 1.0 || sketch_cdf(sketch, -1.0) != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)sketch );
+  return ret;
+}
+
+int8_t test_percentiles()
+{
+  size_t i;
+  size_t q;
+  size_t rank;
+  size_t below;
+  size_t not_above;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * bytes;
+  uint8_t * samples;
+  uint16_t * adc;
+  uint16_t * adc_sorted;
+  int32_t * signed_set;
+  int32_t * signed_sorted;
+  double * doubles;
+  uint8_t out_u8[PERCENTILE_COUNT];
+  uint16_t out_u16[PERCENTILE_COUNT];
+  int32_t out_i32[PERCENTILE_COUNT];
+  double out_f64[PERCENTILE_COUNT];
+  const double qs[PERCENTILE_COUNT] = {0.99, 0.01, 0.05, 0.25, 0.5, 0.75, 0.95, 0.5, -0.5, 1.5};
+
+  PRINTF("test_percentiles()\n");
+  bytes = (uint8_t*)reserve_words((TYPED_SET_SIZE * (sizeof(double) + 2 * sizeof(int32_t) + 2 * sizeof(uint16_t)) + STATS_SET_SIZE_B) / sizeof(int32_t));
+  if (! bytes )
+  {
+    return TEST_ERROR;
+  }
+  doubles = (double*)bytes;
+  signed_set = (int32_t*)(doubles + TYPED_SET_SIZE);
+  signed_sorted = signed_set + TYPED_SET_SIZE;
+  adc = (uint16_t*)(signed_sorted + TYPED_SET_SIZE);
+  adc_sorted = adc + TYPED_SET_SIZE;
+  samples = (uint8_t*)(adc_sorted + TYPED_SET_SIZE);
+
+  fill_random((uint8_t*)signed_set, TYPED_SET_SIZE * sizeof(int32_t), 0x9E7C);
+  fill_random((uint8_t*)adc, TYPED_SET_SIZE * sizeof(uint16_t), 0x9E7D);
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    adc[i] &= 0x0FFF;
+    signed_set[i] %= 5000;
+    adc_sorted[i] = adc[i];
+    doubles[i] = (double)signed_set[i] / 7.0;
+  }
+
+  /* Every type at once, the rank of quantile q is round(q * (n - 1)) */
+  find_percentiles(adc, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_u16);
+  sort_radix_u16(adc_sorted, TYPED_SET_SIZE, (uint16_t*)signed_sorted, SORT_ASCENDING);
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    signed_sorted[i] = signed_set[i];
+  }
+  find_percentiles((const int32_t*)signed_set, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_i32);
+  sort_generic(signed_sorted, TYPED_SET_SIZE, sizeof(int32_t), compare_i32);
+  find_percentiles(doubles, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_f64);
+  fill_random(samples, STATS_SET_SIZE_B, 0x9E7E);
+  find_percentiles(samples, STATS_SET_SIZE_B, qs, PERCENTILE_COUNT, out_u8);
+
+  for (q = 0; q < PERCENTILE_COUNT; q++)
+  {
+    rank = (size_t)((qs[q] < 0.0 ? 0.0 : qs[q] > 1.0 ? 1.0 : qs[q]) * (TYPED_SET_SIZE - 1) + 0.5);
+    if (out_u16[q] != adc_sorted[rank] || out_i32[q] != signed_sorted[rank])
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* The double answer has the requested rank in the unsorted input */
+    below = 0;
+    not_above = 0;
+    for (i = 0; i < TYPED_SET_SIZE; i++)
+    {
+      below += doubles[i] < out_f64[q];
+      not_above += doubles[i] <= out_f64[q];
+    }
+    if (below > rank || not_above <= rank)
+    {
+      ret = TEST_ERROR;
+    }
+
+    rank = (size_t)((qs[q] < 0.0 ? 0.0 : qs[q] > 1.0 ? 1.0 : qs[q]) * (STATS_SET_SIZE_B - 1) + 0.5);
+    if (out_u8[q] != find_kth(samples, STATS_SET_SIZE_B, rank))
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* The inputs are left untouched and an empty array yields zeros */
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    if (doubles[i] != (double)signed_set[i] / 7.0)
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  if (find_percentiles(adc, 0, qs, PERCENTILE_COUNT, out_u16) != 0 || out_u16[0] != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)bytes );
+  return ret;
+}
+
+int8_t test_moments()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * bytes;
+  double * doubles;
+  double mean = 0.0;
+  double m2 = 0.0;
+  double m3 = 0.0;
+  double m4 = 0.0;
+  double d;
+  stats_summary_t summary;
+  stats_f64_t result_f64;
+  stats_i32_t result_i32;
+  int32_t skewed[MOMENTS_SKEWED_SIZE] = {1, 1, 1, 1, 1, 1, 1, 1, 1, 11};
+
+  PRINTF("test_moments()\n");
+  bytes = (uint8_t*)reserve_words((MOMENTS_SET_SIZE * sizeof(double) + STATS_SET_SIZE_B) / sizeof(int32_t));
+  if (! bytes )
+  {
+    return TEST_ERROR;
+  }
+  doubles = (double*)(bytes + STATS_SET_SIZE_B);
+
+  /* Byte summary against a two pass reference */
+  fill_random(bytes, STATS_SET_SIZE_B, 0x4D30);
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    bytes[i] = bytes[i] % 4 ? bytes[i] % 201 : 42;
+  }
+  bytes[10] = 0;
+  bytes[11] = 200;
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    mean += bytes[i];
+  }
+  mean /= STATS_SET_SIZE_B;
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    d = bytes[i] - mean;
+    m2 += d * d;
+    m3 += d * d * d;
+    m4 += d * d * d * d;
+  }
+  m2 /= STATS_SET_SIZE_B;
+  m3 /= STATS_SET_SIZE_B;
+  m4 /= STATS_SET_SIZE_B;
+  summary = compute_summary(bytes, STATS_SET_SIZE_B);
+  if (summary.mode != 42 || summary.range != 200 ||
+      summary.variance < m2 * (1 - MOMENTS_TOLERANCE) || summary.variance > m2 * (1 + MOMENTS_TOLERANCE) ||
+      summary.stddev * summary.stddev < m2 * (1 - MOMENTS_TOLERANCE) ||
+      summary.skewness - m3 / (m2 * summary.stddev) > MOMENTS_TOLERANCE ||
+      m3 / (m2 * summary.stddev) - summary.skewness > MOMENTS_TOLERANCE ||
+      summary.kurtosis - (m4 / (m2 * m2) - 3.0) > MOMENTS_TOLERANCE ||
+      (m4 / (m2 * m2) - 3.0) - summary.kurtosis > MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Values 1e9 + 0..3, where a naive sum of squares loses every digit of the variance of 1.25 */
+  for (i = 0; i < MOMENTS_SET_SIZE; i++)
+  {
+    doubles[i] = 1e9 + (double)(i % 4);
+  }
+  result_f64 = stats_compute(doubles, MOMENTS_SET_SIZE);
+  if (result_f64.range != 3.0 || result_f64.mean - 1e9 != 1.5 ||
+      result_f64.variance < 1.25 - MOMENTS_TOLERANCE || result_f64.variance > 1.25 + MOMENTS_TOLERANCE ||
+      result_f64.skewness > MOMENTS_TOLERANCE || result_f64.skewness < -MOMENTS_TOLERANCE ||
+      result_f64.kurtosis > -1.36 + MOMENTS_TOLERANCE || result_f64.kurtosis < -1.36 - MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Nine ones and one eleven: variance 9, skewness 8/3, excess kurtosis 46/9 */
+  result_i32 = stats_compute(skewed, MOMENTS_SKEWED_SIZE);
+  if (result_i32.variance != 9.0 || result_i32.stddev != 3.0 || result_i32.range != 10.0 ||
+      result_i32.skewness < 8.0 / 3.0 - MOMENTS_TOLERANCE || result_i32.skewness > 8.0 / 3.0 + MOMENTS_TOLERANCE ||
+      result_i32.kurtosis < 46.0 / 9.0 - MOMENTS_TOLERANCE || result_i32.kurtosis > 46.0 / 9.0 + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  summary = compute_summary(bytes, 0);
+  if (summary.variance != 0.0 || summary.mode != 0 || summary.range != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)bytes );
+  return ret;
+}
+
+int8_t test_dataset()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * other;
+  stats_dataset_t dataset;
+  stats_dataset_t other_dataset;
+  stats_summary_t expected;
+  const stats_summary_t * cached;
+
+  PRINTF("test_dataset()\n");
+  set = (uint8_t*)reserve_words(2 * DATASET_SET_SIZE_B / sizeof(int32_t));
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  other = set + DATASET_SET_SIZE_B;
+
+  fill_random(set, 2 * DATASET_SET_SIZE_B, 0xDA7A);
+  dataset_attach(&dataset, set, DATASET_SET_SIZE_B);
+  dataset_attach(&other_dataset, other, DATASET_SET_SIZE_B);
+
+  /* Writes through the setters, including one into the other dataset */
+  set_value((char*)set, 7, (char)255);
+  clear_value((char*)set, 8);
+  set_value((char*)set, 9, (char)set[9]);
+  set_all((char*)set + 100, 3, 50);
+  set_value((char*)other, 0, 0);
+  expected = compute_summary(set, DATASET_SET_SIZE_B);
+  cached = dataset_summary(&dataset);
+  if (cached->count != expected.count || cached->sum != expected.sum ||
+      cached->median != expected.median || cached->maximum != 255 || cached->minimum != 0 ||
+      cached->mode != expected.mode || cached->variance != expected.variance)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < STATS_HISTOGRAM_BINS; i++)
+  {
+    if (cached->histogram[i] != expected.histogram[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* Announced direct writes, disjoint ranges and setter writes inside the dirty range */
+  dataset_invalidate(&dataset, 2000, 2100);
+  my_memset(set + 2000, 100, 200);
+  dataset_invalidate(&dataset, 10, 20);
+  my_memzero(set + 10, 10);
+  set_value((char*)set, 2050, 1);
+  set_value((char*)set, 500, 17);
+  dataset_invalidate(&dataset, DATASET_SET_SIZE_B - 5, DATASET_SET_SIZE_B + 100);
+  set[DATASET_SET_SIZE_B - 1] = 42;
+  expected = compute_summary(set, DATASET_SET_SIZE_B);
+  cached = dataset_summary(&dataset);
+  if (cached->sum != expected.sum || cached->sum_squares != expected.sum_squares ||
+      cached->median != expected.median || cached->mode != expected.mode || cached->histogram[200] != expected.histogram[200])
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* A second query without writes returns the same summary */
+  if (dataset_summary(&dataset)->sum != expected.sum)
+  {
+    ret = TEST_ERROR;
+  }
+
+  expected = compute_summary(other, DATASET_SET_SIZE_B);
+  if (dataset_summary(&other_dataset)->sum != expected.sum || dataset_summary(&other_dataset)->histogram[0] != expected.histogram[0])
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Detached datasets no longer see the writes */
+  dataset_detach(&dataset);
+  dataset_detach(&other_dataset);
+  expected = *dataset_summary(&dataset);
+  set_value((char*)set, 0, (char)(set[0] + 1));
+  if (dataset_summary(&dataset)->sum != expected.sum)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_top_k()
+{
+  size_t i;
+  size_t j;
+  size_t k;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * sorted;
+  uint8_t * out;
+  uint32_t * words;
+  uint32_t * words_sorted;
+  size_t sizes[2] = {STATS_SET_SIZE_B, STATS_SMALL_SIZE};
+  size_t ks[4] = {1, TOP_K_COUNT, STATS_SMALL_SIZE, STATS_SET_SIZE_B + 1};
+  size_t expected;
+
+  PRINTF("test_top_k()\n");
+  set = (uint8_t*)reserve_words((3 * STATS_SET_SIZE_B + 2 * SORT_SET_SIZE_W * sizeof(uint32_t)) / sizeof(int32_t));
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  sorted = set + STATS_SET_SIZE_B;
+  out = sorted + STATS_SET_SIZE_B;
+  words = (uint32_t*)(out + STATS_SET_SIZE_B);
+  words_sorted = words + SORT_SET_SIZE_W;
+
+  fill_random(set, STATS_SET_SIZE_B, 0x70CC);
+  for (i = 0; i < 2; i++)
+  {
+    my_memcopy(set, sorted, sizes[i]);
+    sort_array(sorted, sizes[i]);
+    for (j = 0; j < 4; j++)
+    {
+      expected = ks[j] < sizes[i] ? ks[j] : sizes[i];
+      if (find_top_k(set, sizes[i], ks[j], out) != expected)
+      {
+        ret = TEST_ERROR;
+      }
+      for (k = 0; k < expected; k++)
+      {
+        if (out[k] != sorted[k])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+      if (find_bottom_k(set, sizes[i], ks[j], out) != expected)
+      {
+        ret = TEST_ERROR;
+      }
+      for (k = 0; k < expected; k++)
+      {
+        if (out[k] != sorted[sizes[i] - expected + k])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+  if (find_top_k(set, STATS_SET_SIZE_B, 0, out) != 0 || find_bottom_k(set, 0, TOP_K_COUNT, out) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Both engines of sort_partial, the heap for small k and select plus sort for large k */
+  fill_random((uint8_t*)words, SORT_SET_SIZE_W * sizeof(uint32_t), 0x70CD);
+  my_memcopy((uint8_t*)words, (uint8_t*)words_sorted, SORT_SET_SIZE_W * sizeof(uint32_t));
+  sort_generic(words_sorted, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32);
+  for (j = 0; j < 2; j++)
+  {
+    expected = j ? SORT_SET_SIZE_W / 2 : TOP_K_COUNT;
+    sort_partial(words, SORT_SET_SIZE_W, sizeof(uint32_t), compare_u32, expected);
+    for (i = 0; i < SORT_SET_SIZE_W; i++)
+    {
+      if (i < expected ? words[i] != words_sorted[i] : words[i] < words_sorted[expected - 1])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_robust()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * deviations;
+  uint8_t * bitmap;
+  uint8_t quartiles[2];
+  double qs[2] = {0.25, 0.75};
+  size_t planted[ROBUST_OUTLIER_COUNT] = {0, 3, 64, 65, 500, 998, STATS_SET_SIZE_B - 1};
+  size_t next = 0;
+  uint8_t median;
+  stats_robust_t robust;
+
+  PRINTF("test_robust()\n");
+  set = (uint8_t*)reserve_words((2 * STATS_SET_SIZE_B + ROBUST_BITMAP_BYTES(STATS_SET_SIZE_B)) / sizeof(int32_t) + 1);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  deviations = set + STATS_SET_SIZE_B;
+  bitmap = deviations + STATS_SET_SIZE_B;
+
+  /* Samples between 100 and 139, planted outliers at both ends */
+  fill_random(set, STATS_SET_SIZE_B, 0x0B57);
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    set[i] = 100 + set[i] % 40;
+  }
+  for (i = 0; i < ROBUST_OUTLIER_COUNT; i++)
+  {
+    set[planted[i]] = i % 2 ? 255 : 2;
+  }
+
+  robust = robust_compute(set, STATS_SET_SIZE_B, ROBUST_TUKEY_K);
+  median = find_median(set, STATS_SET_SIZE_B);
+  find_percentiles(set, STATS_SET_SIZE_B, qs, 2, quartiles);
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    deviations[i] = set[i] < median ? median - set[i] : set[i] - median;
+  }
+  if (robust.count != STATS_SET_SIZE_B || robust.median != median ||
+      robust.q1 != quartiles[0] || robust.q3 != quartiles[1] || robust.iqr != quartiles[1] - quartiles[0] ||
+      robust.mad != find_median(deviations, STATS_SET_SIZE_B) ||
+      robust.lower_fence != quartiles[0] - ROBUST_TUKEY_K * robust.iqr)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Only the planted samples are flagged */
+  if (robust_flag_outliers(set, STATS_SET_SIZE_B, ROBUST_TUKEY_K, bitmap, &robust) != ROBUST_OUTLIER_COUNT ||
+      robust.median != median)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < STATS_SET_SIZE_B; i++)
+  {
+    if (((bitmap[i / 8] >> (i % 8)) & 1) != (next < ROBUST_OUTLIER_COUNT && planted[next] == i))
+    {
+      ret = TEST_ERROR;
+    }
+    next += (next < ROBUST_OUTLIER_COUNT && planted[next] == i) ? 1 : 0;
+  }
+
+  /* Odd size tail byte and the empty array */
+  if (robust_flag_outliers(set + 5, 5, ROBUST_TUKEY_K, bitmap, NULL) != 0 || bitmap[0] != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  robust = robust_compute(set, 0, ROBUST_TUKEY_K);
+  if (robust.count != 0 || robust.mad != 0 || robust_flag_outliers(set, 0, ROBUST_TUKEY_K, bitmap, NULL) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_pair()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * x;
+  uint8_t * y;
+  double * dx;
+  double * dy;
+  double mean_x = 0.0;
+  double mean_y = 0.0;
+  double var_x = 0.0;
+  double var_y = 0.0;
+  double cov = 0.0;
+  double r;
+  stats_pair_t pair;
+
+  PRINTF("test_pair()\n");
+  x = (uint8_t*)reserve_words((2 * TYPED_SET_SIZE + 2 * TYPED_SET_SIZE * sizeof(double)) / sizeof(int32_t));
+  if (! x )
+  {
+    return TEST_ERROR;
+  }
+  y = x + TYPED_SET_SIZE;
+  dx = (double*)(y + TYPED_SET_SIZE);
+  dy = dx + TYPED_SET_SIZE;
+
+  /* y = 2x + 3 and y = 255 - x */
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    x[i] = (uint8_t)(i % 100);
+    y[i] = (uint8_t)(2 * x[i] + 3);
+  }
+  pair = stats_pair_compute(x, y, TYPED_SET_SIZE);
+  if (pair.count != TYPED_SET_SIZE || pair.correlation < 1.0 - MOMENTS_TOLERANCE ||
+      pair.slope < 2.0 - MOMENTS_TOLERANCE || pair.slope > 2.0 + MOMENTS_TOLERANCE ||
+      pair.intercept < 3.0 - MOMENTS_TOLERANCE || pair.intercept > 3.0 + MOMENTS_TOLERANCE ||
+      pair.mean_x != 49.5 || pair.variance_x < 833.25 - MOMENTS_TOLERANCE || pair.variance_x > 833.25 + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    y[i] = (uint8_t)(255 - x[i]);
+  }
+  pair = stats_pair_compute(x, y, TYPED_SET_SIZE);
+  if (pair.correlation > -1.0 + MOMENTS_TOLERANCE || pair.intercept < 255.0 - MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Random bytes against a two pass reference */
+  fill_random(x, 2 * TYPED_SET_SIZE, 0xC0F1);
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    y[i] = (uint8_t)((x[i] + y[i]) / 2);
+    mean_x += x[i];
+    mean_y += y[i];
+  }
+  mean_x /= TYPED_SET_SIZE;
+  mean_y /= TYPED_SET_SIZE;
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    var_x += (x[i] - mean_x) * (x[i] - mean_x);
+    var_y += (y[i] - mean_y) * (y[i] - mean_y);
+    cov += (x[i] - mean_x) * (y[i] - mean_y);
+  }
+  r = cov / sqrt(var_x * var_y);
+  cov /= TYPED_SET_SIZE;
+  pair = stats_pair_compute(x, y, TYPED_SET_SIZE);
+  if (pair.covariance < cov - MOMENTS_TOLERANCE || pair.covariance > cov + MOMENTS_TOLERANCE ||
+      pair.correlation < r - MOMENTS_TOLERANCE || pair.correlation > r + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Large offset, where a naive sum of products loses every digit of the covariance of 2.5 */
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    dx[i] = 1e9 + (double)(i % 4);
+    dy[i] = 2.0 * (double)(i % 4) - 7.0;
+  }
+  pair = stats_pair_compute(dx, dy, TYPED_SET_SIZE);
+  if (pair.covariance < 2.5 - MOMENTS_TOLERANCE || pair.covariance > 2.5 + MOMENTS_TOLERANCE ||
+      pair.correlation < 1.0 - MOMENTS_TOLERANCE || pair.slope < 2.0 - MOMENTS_TOLERANCE || pair.slope > 2.0 + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Constant x and empty arrays */
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    dx[i] = 5.0;
+  }
+  pair = stats_pair_compute(dx, dy, TYPED_SET_SIZE);
+  if (pair.correlation != 0.0 || pair.slope != 0.0 || pair.intercept != pair.mean_y || pair.covariance != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+  pair = stats_pair_compute(x, y, 0);
+  if (pair.count != 0 || pair.mean_x != 0.0 || pair.correlation != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)x );
+  return ret;
+}
+
+int8_t test_weighted()
+{
+  size_t i;
+  size_t j;
+  size_t expanded_size = 0;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * samples;
+  uint8_t * expanded;
+  uint32_t * counts;
+  double * weights;
+  uint8_t out[3];
+  uint8_t small[3] = {30, 10, 20};
+  double small_weights[3] = {2.0, 1.0, 1.0};
+  double qs[3] = {0.25, 0.5, 1.0};
+  stats_summary_t summary;
+  stats_weighted_t result;
+
+  PRINTF("test_weighted()\n");
+  samples = (uint8_t*)reserve_words((TYPED_SET_SIZE * (1 + WEIGHTED_MAX_COUNT + sizeof(uint32_t) + sizeof(double))) / sizeof(int32_t));
+  if (! samples )
+  {
+    return TEST_ERROR;
+  }
+  expanded = samples + TYPED_SET_SIZE;
+  counts = (uint32_t*)(expanded + TYPED_SET_SIZE * WEIGHTED_MAX_COUNT);
+  weights = (double*)(counts + TYPED_SET_SIZE);
+
+  /* Integer counts against the expanded array */
+  fill_random(samples, TYPED_SET_SIZE, 0x3E16);
+  for (i = 0; i < TYPED_SET_SIZE; i++)
+  {
+    counts[i] = (samples[i] ^ (uint32_t)i) % WEIGHTED_MAX_COUNT;
+    for (j = 0; j < counts[i]; j++)
+    {
+      expanded[expanded_size++] = samples[i];
+    }
+    weights[i] = 0.5;
+  }
+  summary = compute_summary(expanded, expanded_size);
+  result = stats_weighted_compute(samples, counts, TYPED_SET_SIZE);
+  if (result.total_weight != (double)expanded_size || result.minimum != summary.minimum ||
+      result.maximum != summary.maximum || result.median != summary.median ||
+      result.mean != (double)summary.sum / (double)expanded_size ||
+      result.variance < summary.variance - MOMENTS_TOLERANCE || result.variance > summary.variance + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+  if (find_weighted_percentiles(samples, counts, TYPED_SET_SIZE, qs + 1, 2, out) != 2 ||
+      out[0] != summary.median || out[1] != summary.maximum)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* Equal real weights give the unweighted statistics */
+  summary = compute_summary(samples, TYPED_SET_SIZE);
+  result = stats_weighted_compute(samples, weights, TYPED_SET_SIZE);
+  if (result.count != TYPED_SET_SIZE || result.median != summary.median ||
+      result.variance < summary.variance - MOMENTS_TOLERANCE || result.variance > summary.variance + MOMENTS_TOLERANCE)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* 10, 20, 30, 30 once expanded: the median is 25 */
+  result = stats_weighted_compute(small, small_weights, 3);
+  if (result.median != 25 || result.mean != 22.5 || result.minimum != 10 || result.maximum != 30 ||
+      find_weighted_percentiles(small, small_weights, 3, qs, 3, out) != 3 ||
+      out[0] != 20 || out[1] != 30 || out[2] != 30)
+  {
+    ret = TEST_ERROR;
+  }
+  small_weights[1] = -1.0;
+  small_weights[2] = NAN;
+  result = stats_weighted_compute(small, small_weights, 3);
+  if (result.count != 1 || result.median != 30 || result.minimum != 30 || result.variance != 0.0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  result = stats_weighted_compute(small, counts, 0);
+  if (result.count != 0 || result.median != 0 || find_weighted_percentiles(small, counts, 0, qs, 3, out) != 0 || out[2] != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)samples );
+  return ret;
+}
+
+int8_t test_scratch()
+{
+  size_t i;
+  size_t j;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  uint8_t * copy;
+  int32_t * signed_set;
+  int32_t * signed_copy;
+  uint8_t * buffer;
+  size_t buffer_size = SCRATCH_PERCENTILES_BYTES(TYPED_SET_SIZE, sizeof(int32_t), PERCENTILE_COUNT) + SCRATCH_ROBUST_BYTES;
+  size_t sizes[2] = {STATS_SET_SIZE_B, STATS_SMALL_SIZE + 1};
+  double qs[PERCENTILE_COUNT] = {0.5, 0.01, 0.99, 0.25, 0.75, 0.0, 1.0, 0.5, 0.05, 0.95};
+  int32_t expected_i32[PERCENTILE_COUNT];
+  int32_t out_i32[PERCENTILE_COUNT];
+  uint8_t expected_u8[PERCENTILE_COUNT];
+  uint8_t out_u8[PERCENTILE_COUNT];
+  uint8_t expected_k[TOP_K_COUNT];
+  uint8_t out_k[TOP_K_COUNT];
+  uint8_t expected_bottom[TOP_K_COUNT];
+  uint8_t out_bottom[TOP_K_COUNT];
+  size_t histogram[SELECT_BUCKETS];
+  uint8_t expected_bitmap[ROBUST_BITMAP_BYTES(STATS_SET_SIZE_B)];
+  uint8_t bitmap[ROBUST_BITMAP_BYTES(STATS_SET_SIZE_B)];
+  stats_robust_t expected_robust;
+  stats_robust_t robust;
+  stats_weighted_t expected_weighted;
+  stats_weighted_t weighted;
+  int32_t mode_i32;
+  int32_t expected_mode_i32;
+  uint8_t mode_u8;
+  stats_scratch_t scratch;
+
+  PRINTF("test_scratch()\n");
+  set = (uint8_t*)reserve_words((2 * STATS_SET_SIZE_B + 2 * TYPED_SET_SIZE * sizeof(int32_t) + buffer_size) / sizeof(int32_t) + 1);
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+  copy = set + STATS_SET_SIZE_B;
+  signed_set = (int32_t*)(copy + STATS_SET_SIZE_B);
+  signed_copy = signed_set + TYPED_SET_SIZE;
+  buffer = (uint8_t*)(signed_copy + TYPED_SET_SIZE);
+
+  /* One arena for every call */
+  scratch_init(&scratch, buffer, buffer_size);
+  fill_random(set, STATS_SET_SIZE_B, 0x5C7A);
+  fill_random((uint8_t*)signed_set, TYPED_SET_SIZE * sizeof(int32_t), 0x5C7B);
+  for (i = 0; i < 2; i++)
+  {
+    my_memcopy(set, copy, sizes[i]);
+    if (find_median_scratch(set, sizes[i], &scratch, STATS_KEEP_INPUT) != find_median(copy, sizes[i]) ||
+        find_kth_scratch(set, sizes[i], 3, &scratch, STATS_KEEP_INPUT) != find_kth(copy, sizes[i], 3) ||
+        find_kth_scratch(set, sizes[i], sizes[i], &scratch, STATS_KEEP_INPUT) != 0 ||
+        scratch_mark(&scratch) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    for (j = 0; j < sizes[i]; j++)
+    {
+      if (set[j] != copy[j])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    /* In place on a copy, the selection reorders it */
+    if (find_median_scratch(copy, sizes[i], &scratch, STATS_MAY_REORDER) != find_median(set, sizes[i]))
+    {
+      ret = TEST_ERROR;
+    }
+    my_memcopy(set, copy, sizes[i]);
+    if (find_kth_scratch(copy, sizes[i], sizes[i] - 1, &scratch, STATS_MAY_REORDER) != find_maximum(set, sizes[i]))
+    {
+      ret = TEST_ERROR;
+    }
+
+    /* Top and bottom k, kept input first and then on a copy that may be reordered */
+    my_memcopy(set, copy, sizes[i]);
+    find_top_k(set, sizes[i], TOP_K_COUNT, expected_k);
+    find_bottom_k(set, sizes[i], TOP_K_COUNT, expected_bottom);
+    if (find_top_k_scratch(copy, sizes[i], TOP_K_COUNT, out_k, &scratch, STATS_KEEP_INPUT) != TOP_K_COUNT ||
+        find_bottom_k_scratch(copy, sizes[i], TOP_K_COUNT, out_bottom, &scratch, STATS_KEEP_INPUT) != TOP_K_COUNT ||
+        copy[0] != set[0] || copy[sizes[i] - 1] != set[sizes[i] - 1])
+    {
+      ret = TEST_ERROR;
+    }
+    for (j = 0; j < TOP_K_COUNT; j++)
+    {
+      if (out_k[j] != expected_k[j] || out_bottom[j] != expected_bottom[j])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    if (find_top_k_scratch(copy, sizes[i], TOP_K_COUNT, out_k, &scratch, STATS_MAY_REORDER) != TOP_K_COUNT ||
+        find_bottom_k_scratch(copy, sizes[i], TOP_K_COUNT, out_bottom, &scratch, STATS_MAY_REORDER) != TOP_K_COUNT)
+    {
+      ret = TEST_ERROR;
+    }
+    for (j = 0; j < TOP_K_COUNT; j++)
+    {
+      if (out_k[j] != expected_k[j] || out_bottom[j] != expected_bottom[j])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+
+    /* Robust and weighted statistics only take their counters from the arena */
+    expected_robust = robust_compute(set, sizes[i], ROBUST_TUKEY_K);
+    robust = robust_compute_scratch(set, sizes[i], ROBUST_TUKEY_K, &scratch);
+    if (robust.count != expected_robust.count || robust.median != expected_robust.median ||
+        robust.q1 != expected_robust.q1 || robust.q3 != expected_robust.q3 || robust.mad != expected_robust.mad)
+    {
+      ret = TEST_ERROR;
+    }
+    select_histogram(set, sizes[i], histogram);
+    robust = robust_from_histogram_scratch(histogram, ROBUST_TUKEY_K, &scratch);
+    if (robust.count != expected_robust.count || robust.mad != expected_robust.mad)
+    {
+      ret = TEST_ERROR;
+    }
+    if (robust_flag_outliers_scratch(set, sizes[i], 0.1, bitmap, &robust, &scratch) !=
+        robust_flag_outliers(set, sizes[i], 0.1, expected_bitmap, NULL) ||
+        robust.iqr != expected_robust.iqr)
+    {
+      ret = TEST_ERROR;
+    }
+    for (j = 0; j < ROBUST_BITMAP_BYTES(sizes[i]); j++)
+    {
+      if (bitmap[j] != expected_bitmap[j])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+    expected_weighted = stats_weighted_u32(set, (const uint32_t*)signed_set, sizes[i]);
+    weighted = stats_weighted_u32_scratch(set, (const uint32_t*)signed_set, sizes[i], &scratch);
+    if (weighted.count != expected_weighted.count || weighted.total_weight != expected_weighted.total_weight ||
+        weighted.median != expected_weighted.median || weighted.mean != expected_weighted.mean ||
+        find_weighted_percentiles_u32_scratch(set, (const uint32_t*)signed_set, sizes[i], qs, PERCENTILE_COUNT, out_u8, &scratch) != PERCENTILE_COUNT ||
+        find_weighted_percentiles_u32(set, (const uint32_t*)signed_set, sizes[i], qs, PERCENTILE_COUNT, expected_u8) != PERCENTILE_COUNT ||
+        scratch_mark(&scratch) != 0)
+    {
+      ret = TEST_ERROR;
+    }
+    for (j = 0; j < PERCENTILE_COUNT; j++)
+    {
+      if (out_u8[j] != expected_u8[j])
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+
+  find_percentiles(set, STATS_SET_SIZE_B, qs, PERCENTILE_COUNT, expected_u8);
+  find_percentiles(signed_set, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, expected_i32);
+  my_memcopy((uint8_t*)signed_set, (uint8_t*)signed_copy, TYPED_SET_SIZE * sizeof(int32_t));
+  if (find_percentiles_scratch(set, STATS_SET_SIZE_B, qs, PERCENTILE_COUNT, out_u8, &scratch, STATS_KEEP_INPUT) != PERCENTILE_COUNT ||
+      find_percentiles_scratch(signed_copy, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_i32, &scratch, STATS_KEEP_INPUT) != PERCENTILE_COUNT ||
+      signed_copy[0] != signed_set[0] || signed_copy[TYPED_SET_SIZE - 1] != signed_set[TYPED_SET_SIZE - 1])
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < PERCENTILE_COUNT; i++)
+  {
+    if (out_u8[i] != expected_u8[i] || out_i32[i] != expected_i32[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+  /* The mode sorts a copy in the arena, or the array itself when it may be reordered */
+  my_memcopy((uint8_t*)signed_set, (uint8_t*)signed_copy, TYPED_SET_SIZE * sizeof(int32_t));
+  if (stats_mode(signed_set, TYPED_SET_SIZE, &expected_mode_i32) != 1 ||
+      stats_mode_scratch(signed_copy, TYPED_SET_SIZE, &mode_i32, &scratch, STATS_KEEP_INPUT) != 1 ||
+      mode_i32 != expected_mode_i32 || signed_copy[0] != signed_set[0] ||
+      stats_mode_scratch(set, STATS_SET_SIZE_B, &mode_u8, &scratch, STATS_KEEP_INPUT) != 1 ||
+      mode_u8 != stats_u8(set, STATS_SET_SIZE_B).mode ||
+      stats_mode_scratch(signed_copy, TYPED_SET_SIZE, &mode_i32, &scratch, STATS_MAY_REORDER) != 1 ||
+      mode_i32 != expected_mode_i32 || scratch_mark(&scratch) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  my_memcopy((uint8_t*)signed_set, (uint8_t*)signed_copy, TYPED_SET_SIZE * sizeof(int32_t));
+
+  if (find_percentiles_scratch(signed_copy, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_i32, &scratch, STATS_MAY_REORDER) != PERCENTILE_COUNT ||
+      scratch_mark(&scratch) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+  for (i = 0; i < PERCENTILE_COUNT; i++)
+  {
+    if (out_i32[i] != expected_i32[i])
+    {
+      ret = TEST_ERROR;
+    }
+  }
+
+  /* An arena that is too small fails cleanly, reordering only needs the ranks */
+  scratch_init(&scratch, buffer, 2 * PERCENTILE_COUNT * sizeof(size_t) + SCRATCH_ALIGN);
+  if (find_median_scratch(set, STATS_SET_SIZE_B, &scratch, STATS_KEEP_INPUT) != 0 ||
+      find_percentiles_scratch(signed_set, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_i32, &scratch, STATS_KEEP_INPUT) != 0 ||
+      out_i32[0] != 0 ||
+      find_percentiles_scratch(signed_set, TYPED_SET_SIZE, qs, PERCENTILE_COUNT, out_i32, &scratch, STATS_MAY_REORDER) != PERCENTILE_COUNT ||
+      out_i32[0] != expected_i32[0] || scratch_mark(&scratch) != 0 ||
+      scratch_alloc(&scratch, 4 * PERCENTILE_COUNT * sizeof(size_t)) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+  if (find_top_k_scratch(set, STATS_SET_SIZE_B, TOP_K_COUNT, out_k, &scratch, STATS_KEEP_INPUT) != 0 ||
+      robust_compute_scratch(set, STATS_SET_SIZE_B, ROBUST_TUKEY_K, &scratch).count != 0 ||
+      robust_flag_outliers_scratch(set, STATS_SET_SIZE_B, ROBUST_TUKEY_K, bitmap, NULL, &scratch) != 0 ||
+      stats_weighted_u32_scratch(set, (const uint32_t*)signed_set, STATS_SET_SIZE_B, &scratch).count != 0 ||
+      stats_mode_scratch(signed_set, TYPED_SET_SIZE, &mode_i32, &scratch, STATS_KEEP_INPUT) != 0 ||
+      mode_i32 != expected_mode_i32 || scratch_mark(&scratch) != 0)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
+int8_t test_pool()
+{
+  size_t i;
+  size_t j;
+  int8_t ret = TEST_NO_ERROR;
+  int32_t * first;
+  int32_t * second;
+  uint8_t * blocks[POOL_TEST_BLOCKS];
+  size_t sizes[POOL_TEST_BLOCKS];
+
+  PRINTF("test_pool()\n");
+
+  /* A freed block is the next one of its class */
+  first = reserve_words(3);
+  free_words(first);
+  second = reserve_words(4);
+  if (first == NULL || second != first)
+  {
+    ret = TEST_ERROR;
+  }
+  free_words(second);
+  free_words(NULL);
+
+  /* Mixed classes and blocks too large for the pool, all live at once */
+  for (i = 0; i < POOL_TEST_BLOCKS; i++)
+  {
+    sizes[i] = (i * 1237u) % (MEMORY_POOL_MAX_BLOCK + MEMORY_POOL_MAX_BLOCK / 2) + 1;
+    blocks[i] = (uint8_t*)reserve_words((sizes[i] + sizeof(int32_t) - 1) / sizeof(int32_t));
+    if (blocks[i] == NULL || (uintptr_t)blocks[i] % 8 != 0)
+    {
+      ret = TEST_ERROR;
+      sizes[i] = 0;
+      continue;
+    }
+    my_memset(blocks[i], sizes[i], (uint8_t)i);
+  }
+  for (i = 0; i < POOL_TEST_BLOCKS; i++)
+  {
+    for (j = 0; j < sizes[i]; j++)
+    {
+      if (blocks[i][j] != (uint8_t)i)
+      {
+        ret = TEST_ERROR;
+      }
+    }
+  }
+  for (i = POOL_TEST_BLOCKS; i > 0; i--)
+  {
+    free_words((int32_t*)blocks[i - 1]);
+  }
+
+  /* The small blocks come back from the free lists */
+  first = reserve_words(1);
+  if (first != (int32_t*)blocks[0])
+  {
+    ret = TEST_ERROR;
+  }
+  free_words(first);
+
+  return ret;
+}
+
+int8_t test_memmove_overlap()
+{
+  size_t i;
+  size_t length;
+  size_t offset;
+  size_t start;
+  size_t target;
+  int8_t ret = TEST_NO_ERROR;
+  int shift;
+  uint8_t * buffer;
+  uint8_t * expected;
+  uint8_t * saved;
+
+  PRINTF("test_memmove_overlap()\n");
+  buffer = (uint8_t*)reserve_words(3 * MOVE_TEST_BUFFER / sizeof(int32_t));
+  if (! buffer )
+  {
+    return TEST_ERROR;
+  }
+  expected = buffer + MOVE_TEST_BUFFER;
+  saved = expected + MOVE_TEST_BUFFER;
+  fill_random(saved, MOVE_TEST_BUFFER, 0x303E);
+
+  for (length = 0; length <= MOVE_TEST_MAX_LENGTH; length++)
+  {
+    for (offset = 0; offset < 8; offset++)
+    {
+      for (shift = -MOVE_TEST_MAX_SHIFT; shift <= MOVE_TEST_MAX_SHIFT; shift++)
+      {
+        start = MOVE_TEST_MAX_SHIFT + offset;
+        target = (size_t)((int)start + shift);
+        for (i = 0; i < MOVE_TEST_BUFFER; i++)
+        {
+          buffer[i] = saved[i];
+          expected[i] = saved[i];
+        }
+        for (i = 0; i < length; i++)
+        {
+          expected[target + i] = saved[start + i];
+        }
+        if (my_memmove(buffer + start, buffer + target, length) != buffer + target)
+        {
+          ret = TEST_ERROR;
+        }
+        for (i = 0; i < MOVE_TEST_BUFFER; i++)
+        {
+          if (buffer[i] != expected[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+  }
+
+  free_words( (int32_t*)buffer );
+  return ret;
+}
+
+int8_t test_memcopy_engines()
+{
+  const memcopy_engine_t * list[MEMCOPY_MAX_ENGINES];
+  size_t count;
+  size_t engine;
+  size_t i;
+  size_t length;
+  size_t src_offset;
+  size_t dst_offset;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * src;
+  uint8_t * dst;
+  uint8_t * expected;
+
+  PRINTF("test_memcopy_engines()\n");
+  src = (uint8_t*)reserve_words(3 * COPY_TEST_BUFFER / sizeof(int32_t));
+  if (! src )
+  {
+    return TEST_ERROR;
+  }
+  dst = src + COPY_TEST_BUFFER;
+  expected = dst + COPY_TEST_BUFFER;
+  fill_random(src, COPY_TEST_BUFFER, 0x4C0B);
+  count = memcopy_available(list, MEMCOPY_MAX_ENGINES);
+
+  if (my_memcopy(NULL, dst, 1) != NULL || my_memcopy(src, NULL, 1) != NULL ||
+      my_memcopy_reference(NULL, dst, 1) != NULL)
+  {
+    ret = TEST_ERROR;
+  }
+
+  /* The last round runs my_memcopy itself, whatever engine it selected */
+  for (engine = 0; engine <= count; engine++)
+  {
+    #ifdef VERBOSE
+    PRINTF("  memcopy: %s\n", engine < count ? list[engine]->name : memcopy_get()->name);
+    #endif
+    for (length = 0; length <= COPY_TEST_MAX_LENGTH; length += 1 + length / 16)
+    {
+      for (src_offset = 0; src_offset < COPY_TEST_MAX_OFFSET; src_offset++)
+      {
+        for (dst_offset = 0; dst_offset < COPY_TEST_MAX_OFFSET; dst_offset++)
+        {
+          for (i = 0; i < COPY_TEST_BUFFER; i++)
+          {
+            dst[i] = (uint8_t)i;
+            expected[i] = (uint8_t)i;
+          }
+          my_memcopy_reference(src + src_offset, expected + dst_offset, length);
+          if (engine < count)
+          {
+            list[engine]->copy(src + src_offset, dst + dst_offset, length);
+          }
+          else if (my_memcopy(src + src_offset, dst + dst_offset, length) != dst + dst_offset)
+          {
+            ret = TEST_ERROR;
+          }
+          for (i = 0; i < COPY_TEST_BUFFER; i++)
+          {
+            if (dst[i] != expected[i])
+            {
+              ret = TEST_ERROR;
+            }
+          }
+        }
+      }
+    }
+  }
+
+  free_words( (int32_t*)src );
+  return ret;
+}
+
+int8_t test_memcopy_stream()
+{
+  size_t i;
+  size_t length;
+  size_t src_offset;
+  size_t dst_offset;
+  size_t cache;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * src;
+  uint8_t * dst;
+  uint8_t * expected;
+
+  PRINTF("test_memcopy_stream() - cache %zu bytes\n", memcopy_cache_size());
+  src = (uint8_t*)reserve_words(3 * COPY_TEST_BUFFER / sizeof(int32_t));
+  if (! src )
+  {
+    return TEST_ERROR;
+  }
+  dst = src + COPY_TEST_BUFFER;
+  expected = dst + COPY_TEST_BUFFER;
+  fill_random(src, COPY_TEST_BUFFER, 0x5EA1);
+
+  cache = memcopy_cache_size();
+  if (memcopy_get_stream_threshold() != (cache != 0 ? cache : SIZE_MAX))
+  {
+    ret = TEST_ERROR;
+  }
+
+  memcopy_set_stream_threshold(COPY_TEST_STREAM_THRESHOLD);
+  if (memcopy_get_stream_threshold() != COPY_TEST_STREAM_THRESHOLD)
+  {
+    ret = TEST_ERROR;
+  }
+
+  for (length = 0; length <= COPY_TEST_MAX_LENGTH; length += 1 + length / 16)
+  {
+    for (src_offset = 0; src_offset < COPY_TEST_MAX_OFFSET; src_offset++)
+    {
+      for (dst_offset = 0; dst_offset < COPY_TEST_MAX_OFFSET; dst_offset++)
+      {
+        for (i = 0; i < COPY_TEST_BUFFER; i++)
+        {
+          dst[i] = (uint8_t)i;
+          expected[i] = (uint8_t)i;
+        }
+        my_memcopy_reference(src + src_offset, expected + dst_offset, length);
+        if (my_memcopy(src + src_offset, dst + dst_offset, length) != dst + dst_offset)
+        {
+          ret = TEST_ERROR;
+        }
+        for (i = 0; i < COPY_TEST_BUFFER; i++)
+        {
+          if (dst[i] != expected[i])
+          {
+            ret = TEST_ERROR;
+          }
+        }
+      }
+    }
+
+    /* The fill only depends on the destination offset */
+    for (dst_offset = 0; dst_offset < COPY_TEST_MAX_OFFSET; dst_offset++)
+    {
+      for (i = 0; i < COPY_TEST_BUFFER; i++)
+      {
+        dst[i] = (uint8_t)i;
+        expected[i] = (uint8_t)i;
+      }
+      for (i = 0; i < length; i++)
+      {
+        expected[dst_offset + i] = (uint8_t)(0xA5 + length);
+      }
+      if (my_memset(dst + dst_offset, length, (uint8_t)(0xA5 + length)) != dst + dst_offset)
+      {
+        ret = TEST_ERROR;
+      }
+      for (i = 0; i < COPY_TEST_BUFFER; i++)
+      {
+        if (dst[i] != expected[i])
+        {
+          ret = TEST_ERROR;
+        }
+      }
+    }
+  }
+
+  memcopy_set_stream_threshold(0);
+  if (memcopy_get_stream_threshold() != (cache != 0 ? cache : SIZE_MAX))
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)src );
+  return ret;
+}
+
+int8_t test_large_input()
+{
+  size_t i;
+  int8_t ret = TEST_NO_ERROR;
+  uint8_t * set;
+  size_t cycles = LARGE_INPUT_SIZE_B / 256;
+  stats_summary_t summary;
+
+  PRINTF("test_large_input() - %zu bytes\n", (size_t)LARGE_INPUT_SIZE_B);
+  if (LARGE_INPUT_SIZE_B % 256 != 0)
+  {
+    return TEST_ERROR;
+  }
+  set = (uint8_t*)reserve_words(LARGE_INPUT_SIZE_B / sizeof(int32_t));
+  if (! set )
+  {
+    return TEST_ERROR;
+  }
+
+  /* Every value appears LARGE_INPUT_SIZE_B/256 times */
+  for (i = 0; i < LARGE_INPUT_SIZE_B; i++)
+  {
+    set[i] = (uint8_t)i;
+  }
+
+  if (find_minimum(set, LARGE_INPUT_SIZE_B) != 0 ||
+      find_maximum(set, LARGE_INPUT_SIZE_B) != 255 ||
+      find_mean(set, LARGE_INPUT_SIZE_B) != 127 ||
+      find_median(set, LARGE_INPUT_SIZE_B) != 127 ||
+      find_kth(set, LARGE_INPUT_SIZE_B, LARGE_INPUT_SIZE_B - 1) != 255 ||
+      find_kth(set, LARGE_INPUT_SIZE_B, LARGE_INPUT_SIZE_B / 2) != 128)
+  {
+    ret = TEST_ERROR;
+  }
+
+  summary = compute_summary(set, LARGE_INPUT_SIZE_B);
+  if (summary.count != LARGE_INPUT_SIZE_B ||
+      summary.sum != (uint64_t)cycles * 32640u ||
+      summary.histogram[0] != cycles || summary.histogram[255] != cycles)
+  {
+    ret = TEST_ERROR;
+  }
+
+  free_words( (int32_t*)set );
+  return ret;
+}
+
 void course1(void) 
 {
   uint8_t i;
@@ -335,6 +2410,32 @@ void course1(void)
   results[5] = test_memcopy();
   results[6] = test_memset();
   results[7] = test_reverse();
+  results[8] = test_kth();
+  results[9] = test_summary();
+  results[10] = test_kernels();
+  results[11] = test_accum();
+  results[12] = test_summary_merge();
+  results[13] = test_parallel();
+  results[14] = test_sort();
+  results[15] = test_sort_parallel();
+  results[16] = test_typed();
+  results[17] = test_window();
+  results[18] = test_sketch();
+  results[19] = test_percentiles();
+  results[20] = test_moments();
+  results[21] = test_dataset();
+  results[22] = test_top_k();
+  results[23] = test_robust();
+  results[24] = test_pair();
+  results[25] = test_weighted();
+  results[26] = test_scratch();
+  results[27] = test_pool();
+  results[28] = test_memmove_overlap();
+  results[29] = test_memcopy_engines();
+  results[30] = test_memcopy_stream();
+#ifdef LARGE_INPUT
+  results[TESTCOUNT - 1] = test_large_input();
+#endif
 
   for ( i = 0; i < TESTCOUNT; i++) 
   {
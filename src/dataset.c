@@ -0,0 +1,164 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file dataset.c
+ * @brief File containing the definition of the cached dataset handle.
+ *
+ * The attached datasets form a list whose head is the context of the memory.h write hook. The hook
+ * moves one count of the histogram from the old to the new value of the byte, unless the byte is
+ * in the dirty range, whose bytes are not counted until the next query. A dirty range is a single
+ * interval: merging a range that does not touch it also takes the bytes in between out of the
+ * histogram, which keeps the bookkeeping O(1) per write.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "dataset.h"
+#include "memory.h"
+#include "summary.h"
+
+static void dataset_write_hook(void * context, char * ptr, unsigned int index, char value);
+static void dataset_uncount(stats_dataset_t * dataset, size_t begin, size_t end);
+
+/* Attached datasets */
+static stats_dataset_t * attached = NULL;
+
+/* Function definition*/
+void dataset_attach(stats_dataset_t * dataset, unsigned char * data, size_t length)
+{
+  dataset->data = data;
+  dataset->length = length;
+  dataset->dirty_begin = 0;
+  dataset->dirty_end = 0;
+  dataset->stale = 0;
+  dataset->summary = compute_summary(data, length);
+
+  dataset->next = attached;
+  attached = dataset;
+  memory_set_write_hook(dataset_write_hook, attached);
+}
+
+void dataset_detach(stats_dataset_t * dataset)
+{
+  stats_dataset_t ** link = &attached;
+
+  while(*link != NULL && *link != dataset)
+  {
+    link = &(*link)->next;
+  }
+  if(*link != NULL)
+  {
+    *link = dataset->next;
+  }
+  dataset->next = NULL;
+
+  memory_set_write_hook(attached != NULL ? dataset_write_hook : NULL, attached);
+}
+
+void dataset_invalidate(stats_dataset_t * dataset, size_t begin, size_t end)
+{
+  end = end > dataset->length ? dataset->length : end;
+  if(begin >= end)
+  {
+    return;
+  }
+
+  if(dataset->dirty_begin == dataset->dirty_end)
+  {
+    dataset_uncount(dataset, begin, end);
+    dataset->dirty_begin = begin;
+    dataset->dirty_end = end;
+  }
+  else
+  {
+    /* Only the part of the union that is not dirty yet is still counted */
+    if(begin < dataset->dirty_begin)
+    {
+      dataset_uncount(dataset, begin, dataset->dirty_begin);
+      dataset->dirty_begin = begin;
+    }
+    if(end > dataset->dirty_end)
+    {
+      dataset_uncount(dataset, dataset->dirty_end, end);
+      dataset->dirty_end = end;
+    }
+  }
+  dataset->stale = 1;
+}
+
+const stats_summary_t * dataset_summary(stats_dataset_t * dataset)
+{
+  size_t i;
+
+  for(i = dataset->dirty_begin; i < dataset->dirty_end; ++i)
+  {
+    ++dataset->summary.histogram[*(dataset->data+i)];
+  }
+  dataset->dirty_begin = 0;
+  dataset->dirty_end = 0;
+
+  if(dataset->stale)
+  {
+    summary_from_histogram(&dataset->summary);
+    dataset->stale = 0;
+  }
+
+  return &dataset->summary;
+}
+
+void dataset_print_statistics(stats_dataset_t * dataset)
+{
+  print_summary(dataset_summary(dataset));
+}
+
+static void dataset_write_hook(void * context, char * ptr, unsigned int index, char value)
+{
+  stats_dataset_t * dataset;
+  uintptr_t address = (uintptr_t)(ptr + index);
+  size_t position;
+  unsigned char old_value;
+
+  for(dataset = (stats_dataset_t *)context; dataset != NULL; dataset = dataset->next)
+  {
+    if(address < (uintptr_t)dataset->data || address - (uintptr_t)dataset->data >= dataset->length)
+    {
+      continue;
+    }
+    position = (size_t)(address - (uintptr_t)dataset->data);
+    if(position >= dataset->dirty_begin && position < dataset->dirty_end)
+    {
+      continue;
+    }
+
+    /* Still the old value, the hook runs before the write */
+    old_value = *(dataset->data+position);
+    if(old_value != (unsigned char)value)
+    {
+      --dataset->summary.histogram[old_value];
+      ++dataset->summary.histogram[(unsigned char)value];
+      dataset->stale = 1;
+    }
+  }
+}
+
+static void dataset_uncount(stats_dataset_t * dataset, size_t begin, size_t end)
+{
+  size_t i;
+
+  for(i = begin; i < end; ++i)
+  {
+    --dataset->summary.histogram[*(dataset->data+i)];
+  }
+}
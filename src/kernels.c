@@ -0,0 +1,181 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file kernels.c
+ * @brief File containing the scalar reference kernels and the kernel dispatch.
+ *
+ * The scalar kernels are the original loops of the statistics functions and define the expected
+ * result of every other implementation. The dispatch picks the DSP table on MSP432, the widest
+ * instruction set reported by CPUID on x86 hosts and the scalar table everywhere else.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kernels.h"
+
+static uint8_t scalar_minimum(const uint8_t * src, size_t length);
+static uint8_t scalar_maximum(const uint8_t * src, size_t length);
+static uint64_t scalar_sum(const uint8_t * src, size_t length);
+static void scalar_histogram(const uint8_t * src, size_t length, size_t * histogram);
+
+const stats_kernels_t kernels_scalar =
+{
+  "scalar",
+  scalar_minimum,
+  scalar_maximum,
+  scalar_sum,
+  scalar_histogram
+};
+
+/* Table selected by the dispatch, NULL until the first call to kernels_get */
+static const stats_kernels_t * selected_kernels = NULL;
+
+/* Function definition*/
+static uint8_t scalar_minimum(const uint8_t * src, size_t length)
+{
+  uint8_t minimum = 255;
+  size_t i;
+
+  for(i = 0; i < length ; ++i)
+  {
+    minimum = minimum > *(src+i) ? *(src+i) : minimum;
+  }
+
+  return minimum;
+}
+
+static uint8_t scalar_maximum(const uint8_t * src, size_t length)
+{
+  uint8_t maximum = 0;
+  size_t i;
+
+  for(i = 0; i < length ; ++i)
+  {
+    maximum = maximum < *(src+i) ? *(src+i) : maximum;
+  }
+
+  return maximum;
+}
+
+static uint64_t scalar_sum(const uint8_t * src, size_t length)
+{
+  uint64_t sum_value = 0;
+  size_t i;
+
+  for(i = 0; i < length ; ++i)
+  {
+    sum_value += *(src+i);
+  }
+
+  return sum_value;
+}
+
+static void scalar_histogram(const uint8_t * src, size_t length, size_t * histogram)
+{
+  size_t i;
+
+  for(i = 0; i < 256; ++i)
+  {
+    *(histogram+i) = 0;
+  }
+
+  for(i = 0; i < length; ++i)
+  {
+    ++*(histogram+*(src+i));
+  }
+}
+
+int8_t kernels_supported(const stats_kernels_t * kernels)
+{
+  if(kernels == &kernels_scalar || kernels == &kernels_dsp)
+  {
+    return 1;
+  }
+#ifdef KERNELS_X86
+  __builtin_cpu_init();
+  if(kernels == &kernels_sse2)
+  {
+    return __builtin_cpu_supports("sse2") ? 1 : 0;
+  }
+  if(kernels == &kernels_avx2)
+  {
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+  }
+  if(kernels == &kernels_avx512bw)
+  {
+    return __builtin_cpu_supports("avx512bw") ? 1 : 0;
+  }
+#endif
+  return 0;
+}
+
+size_t kernels_available(const stats_kernels_t ** list, size_t max_size)
+{
+  const stats_kernels_t * candidates[] =
+  {
+    &kernels_scalar,
+    &kernels_dsp,
+#ifdef KERNELS_X86
+    &kernels_sse2,
+    &kernels_avx2,
+    &kernels_avx512bw,
+#endif
+  };
+  size_t count = 0;
+  size_t i;
+
+  for(i = 0; i < sizeof(candidates) / sizeof(candidates[0]) && count < max_size; ++i)
+  {
+    if(kernels_supported(candidates[i]))
+    {
+      *(list+count) = candidates[i];
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+const stats_kernels_t * kernels_get(void)
+{
+  if(selected_kernels == NULL)
+  {
+#if defined (MSP432)
+    selected_kernels = &kernels_dsp;
+#elif defined (KERNELS_X86)
+    /* From the widest to the narrowest instruction set */
+    if(kernels_supported(&kernels_avx512bw))
+    {
+      selected_kernels = &kernels_avx512bw;
+    }
+    else if(kernels_supported(&kernels_avx2))
+    {
+      selected_kernels = &kernels_avx2;
+    }
+    else if(kernels_supported(&kernels_sse2))
+    {
+      selected_kernels = &kernels_sse2;
+    }
+    else
+    {
+      selected_kernels = &kernels_scalar;
+    }
+#else
+    selected_kernels = &kernels_scalar;
+#endif
+  }
+
+  return selected_kernels;
+}
@@ -0,0 +1,194 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file kernels_dsp.c
+ * @brief File containing the Cortex-M4 packed byte reduction kernels.
+ *
+ * The kernels read one aligned 32-bit word per iteration and process its four samples with a single
+ * DSP instruction: USUB8 compares the four byte lanes and SEL keeps the smaller or larger lane for
+ * the minimum and maximum, USADA8 against zero adds the four lanes to the running sum. The histogram
+ * also reads one word per four samples. On MSP432 the instructions come from CMSIS, on other
+ * platforms from the C emulation in dsp_intrinsics.h, so this file behaves the same on both.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kernels.h"
+#include "dsp_intrinsics.h"
+
+/* Aligned word loads from byte buffers, allowed to alias the uint8_t samples */
+typedef uint32_t __attribute__((__may_alias__)) dsp_word_t;
+
+/* USADA8 adds at most 4*255 per word, flush the 32-bit accumulator well before it wraps */
+#define DSP_SUM_FLUSH_WORDS (1u << 20)
+
+static size_t dsp_head_length(const uint8_t * src, size_t length);
+static uint8_t dsp_minimum(const uint8_t * src, size_t length);
+static uint8_t dsp_maximum(const uint8_t * src, size_t length);
+static uint64_t dsp_sum(const uint8_t * src, size_t length);
+static void dsp_histogram(const uint8_t * src, size_t length, size_t * histogram);
+
+const stats_kernels_t kernels_dsp =
+{
+#ifdef DSP_EMULATED
+  "dsp-emulated",
+#else
+  "dsp",
+#endif
+  dsp_minimum,
+  dsp_maximum,
+  dsp_sum,
+  dsp_histogram
+};
+
+/* Function definition*/
+static size_t dsp_head_length(const uint8_t * src, size_t length)
+{
+  size_t head = (4u - ((uintptr_t)src & 3u)) & 3u;
+
+  return head < length ? head : length;
+}
+
+static uint8_t dsp_minimum(const uint8_t * src, size_t length)
+{
+  uint32_t acc = 0xFFFFFFFFu;
+  uint32_t word;
+  uint8_t minimum = 255;
+  uint8_t lane;
+  size_t i;
+  size_t head = dsp_head_length(src, length);
+
+  for(i = 0; i < head; ++i)
+  {
+    minimum = minimum > *(src+i) ? *(src+i) : minimum;
+  }
+
+  for(; i + 4 <= length; i += 4)
+  {
+    word = *(const dsp_word_t *)(src+i);
+    (void)__USUB8(acc, word);     /* GE set on the lanes where acc >= word */
+    acc = __SEL(word, acc);
+  }
+
+  for(lane = 0; lane < 4; ++lane)
+  {
+    minimum = minimum > (uint8_t)(acc >> (8 * lane)) ? (uint8_t)(acc >> (8 * lane)) : minimum;
+  }
+
+  for(; i < length; ++i)
+  {
+    minimum = minimum > *(src+i) ? *(src+i) : minimum;
+  }
+
+  return minimum;
+}
+
+static uint8_t dsp_maximum(const uint8_t * src, size_t length)
+{
+  uint32_t acc = 0;
+  uint32_t word;
+  uint8_t maximum = 0;
+  uint8_t lane;
+  size_t i;
+  size_t head = dsp_head_length(src, length);
+
+  for(i = 0; i < head; ++i)
+  {
+    maximum = maximum < *(src+i) ? *(src+i) : maximum;
+  }
+
+  for(; i + 4 <= length; i += 4)
+  {
+    word = *(const dsp_word_t *)(src+i);
+    (void)__USUB8(word, acc);     /* GE set on the lanes where word >= acc */
+    acc = __SEL(word, acc);
+  }
+
+  for(lane = 0; lane < 4; ++lane)
+  {
+    maximum = maximum < (uint8_t)(acc >> (8 * lane)) ? (uint8_t)(acc >> (8 * lane)) : maximum;
+  }
+
+  for(; i < length; ++i)
+  {
+    maximum = maximum < *(src+i) ? *(src+i) : maximum;
+  }
+
+  return maximum;
+}
+
+static uint64_t dsp_sum(const uint8_t * src, size_t length)
+{
+  uint64_t sum_value = 0;
+  uint32_t acc = 0;
+  uint32_t words = 0;
+  size_t i;
+  size_t head = dsp_head_length(src, length);
+
+  for(i = 0; i < head; ++i)
+  {
+    sum_value += *(src+i);
+  }
+
+  for(; i + 4 <= length; i += 4)
+  {
+    acc = __USADA8(*(const dsp_word_t *)(src+i), 0, acc);
+    if(++words == DSP_SUM_FLUSH_WORDS)
+    {
+      sum_value += acc;
+      acc = 0;
+      words = 0;
+    }
+  }
+  sum_value += acc;
+
+  for(; i < length; ++i)
+  {
+    sum_value += *(src+i);
+  }
+
+  return sum_value;
+}
+
+static void dsp_histogram(const uint8_t * src, size_t length, size_t * histogram)
+{
+  uint32_t word;
+  size_t i;
+  size_t head = dsp_head_length(src, length);
+
+  for(i = 0; i < 256; ++i)
+  {
+    *(histogram+i) = 0;
+  }
+
+  for(i = 0; i < head; ++i)
+  {
+    ++*(histogram+*(src+i));
+  }
+
+  for(; i + 4 <= length; i += 4)
+  {
+    word = *(const dsp_word_t *)(src+i);
+    ++*(histogram+(word & 0xFFu));
+    ++*(histogram+((word >> 8) & 0xFFu));
+    ++*(histogram+((word >> 16) & 0xFFu));
+    ++*(histogram+(word >> 24));
+  }
+
+  for(; i < length; ++i)
+  {
+    ++*(histogram+*(src+i));
+  }
+}
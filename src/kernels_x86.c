@@ -0,0 +1,405 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file kernels_x86.c
+ * @brief File containing the SSE2, AVX2 and AVX-512BW reduction kernels for x86 hosts.
+ *
+ * Minimum and maximum are reduced with the packed unsigned byte min/max instructions (pminub and
+ * pmaxub) into four independent accumulators, and the sum with psadbw against zero, which adds
+ * eight bytes into a 64-bit lane per instruction. The histogram does not vectorize; all three tables
+ * share a version that loads eight samples at a time and spreads them over four sub-histograms, so
+ * runs of equal values do not serialize on the same counter. Every function carries its own target
+ * attribute so the file builds with the default compiler flags; the dispatch in kernels.c makes sure
+ * a table is only used on a CPU that supports it. Nothing in this file is built on other platforms.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "kernels.h"
+
+#ifdef KERNELS_X86
+#include <string.h>
+#include <immintrin.h>
+
+#define SSE2_TARGET     __attribute__((target("sse2")))
+#define AVX2_TARGET     __attribute__((target("avx2")))
+#define AVX512BW_TARGET __attribute__((target("avx512f,avx512bw")))
+
+static uint8_t sse2_minimum(const uint8_t * src, size_t length);
+static uint8_t sse2_maximum(const uint8_t * src, size_t length);
+static uint64_t sse2_sum(const uint8_t * src, size_t length);
+static uint8_t avx2_minimum(const uint8_t * src, size_t length);
+static uint8_t avx2_maximum(const uint8_t * src, size_t length);
+static uint64_t avx2_sum(const uint8_t * src, size_t length);
+static uint8_t avx512bw_minimum(const uint8_t * src, size_t length);
+static uint8_t avx512bw_maximum(const uint8_t * src, size_t length);
+static uint64_t avx512bw_sum(const uint8_t * src, size_t length);
+static void x86_histogram(const uint8_t * src, size_t length, size_t * histogram);
+
+const stats_kernels_t kernels_sse2 =
+{
+  "sse2",
+  sse2_minimum,
+  sse2_maximum,
+  sse2_sum,
+  x86_histogram
+};
+
+const stats_kernels_t kernels_avx2 =
+{
+  "avx2",
+  avx2_minimum,
+  avx2_maximum,
+  avx2_sum,
+  x86_histogram
+};
+
+const stats_kernels_t kernels_avx512bw =
+{
+  "avx512bw",
+  avx512bw_minimum,
+  avx512bw_maximum,
+  avx512bw_sum,
+  x86_histogram
+};
+
+/* Horizontal reductions of one 128-bit register */
+static inline SSE2_TARGET uint8_t reduce_min_128(__m128i acc)
+{
+  acc = _mm_min_epu8(acc, _mm_srli_si128(acc, 8));
+  acc = _mm_min_epu8(acc, _mm_srli_si128(acc, 4));
+  acc = _mm_min_epu8(acc, _mm_srli_si128(acc, 2));
+  acc = _mm_min_epu8(acc, _mm_srli_si128(acc, 1));
+  return (uint8_t)_mm_cvtsi128_si32(acc);
+}
+
+static inline SSE2_TARGET uint8_t reduce_max_128(__m128i acc)
+{
+  acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 8));
+  acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 4));
+  acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 2));
+  acc = _mm_max_epu8(acc, _mm_srli_si128(acc, 1));
+  return (uint8_t)_mm_cvtsi128_si32(acc);
+}
+
+static inline SSE2_TARGET uint64_t reduce_sum_128(__m128i acc)
+{
+  uint64_t lanes[2];
+
+  _mm_storeu_si128((__m128i *)lanes, acc);
+  return lanes[0] + lanes[1];
+}
+
+/* Function definition*/
+static SSE2_TARGET uint8_t sse2_minimum(const uint8_t * src, size_t length)
+{
+  __m128i acc0 = _mm_set1_epi8((char)0xFF);
+  __m128i acc1 = acc0;
+  __m128i acc2 = acc0;
+  __m128i acc3 = acc0;
+  uint8_t minimum;
+  size_t i = 0;
+
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm_min_epu8(acc0, _mm_loadu_si128((const __m128i *)(src+i)));
+    acc1 = _mm_min_epu8(acc1, _mm_loadu_si128((const __m128i *)(src+i+16)));
+    acc2 = _mm_min_epu8(acc2, _mm_loadu_si128((const __m128i *)(src+i+32)));
+    acc3 = _mm_min_epu8(acc3, _mm_loadu_si128((const __m128i *)(src+i+48)));
+  }
+  for(; i + 16 <= length; i += 16)
+  {
+    acc0 = _mm_min_epu8(acc0, _mm_loadu_si128((const __m128i *)(src+i)));
+  }
+
+  minimum = reduce_min_128(_mm_min_epu8(_mm_min_epu8(acc0, acc1), _mm_min_epu8(acc2, acc3)));
+  for(; i < length; ++i)
+  {
+    minimum = minimum > *(src+i) ? *(src+i) : minimum;
+  }
+
+  return minimum;
+}
+
+static SSE2_TARGET uint8_t sse2_maximum(const uint8_t * src, size_t length)
+{
+  __m128i acc0 = _mm_setzero_si128();
+  __m128i acc1 = acc0;
+  __m128i acc2 = acc0;
+  __m128i acc3 = acc0;
+  uint8_t maximum;
+  size_t i = 0;
+
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm_max_epu8(acc0, _mm_loadu_si128((const __m128i *)(src+i)));
+    acc1 = _mm_max_epu8(acc1, _mm_loadu_si128((const __m128i *)(src+i+16)));
+    acc2 = _mm_max_epu8(acc2, _mm_loadu_si128((const __m128i *)(src+i+32)));
+    acc3 = _mm_max_epu8(acc3, _mm_loadu_si128((const __m128i *)(src+i+48)));
+  }
+  for(; i + 16 <= length; i += 16)
+  {
+    acc0 = _mm_max_epu8(acc0, _mm_loadu_si128((const __m128i *)(src+i)));
+  }
+
+  maximum = reduce_max_128(_mm_max_epu8(_mm_max_epu8(acc0, acc1), _mm_max_epu8(acc2, acc3)));
+  for(; i < length; ++i)
+  {
+    maximum = maximum < *(src+i) ? *(src+i) : maximum;
+  }
+
+  return maximum;
+}
+
+static SSE2_TARGET uint64_t sse2_sum(const uint8_t * src, size_t length)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc0 = zero;
+  __m128i acc1 = zero;
+  uint64_t sum_value;
+  size_t i = 0;
+
+  for(; i + 32 <= length; i += 32)
+  {
+    acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(src+i)), zero));
+    acc1 = _mm_add_epi64(acc1, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(src+i+16)), zero));
+  }
+  for(; i + 16 <= length; i += 16)
+  {
+    acc0 = _mm_add_epi64(acc0, _mm_sad_epu8(_mm_loadu_si128((const __m128i *)(src+i)), zero));
+  }
+
+  sum_value = reduce_sum_128(_mm_add_epi64(acc0, acc1));
+  for(; i < length; ++i)
+  {
+    sum_value += *(src+i);
+  }
+
+  return sum_value;
+}
+
+static AVX2_TARGET uint8_t avx2_minimum(const uint8_t * src, size_t length)
+{
+  __m256i acc0 = _mm256_set1_epi8((char)0xFF);
+  __m256i acc1 = acc0;
+  __m256i acc2 = acc0;
+  __m256i acc3 = acc0;
+  uint8_t minimum;
+  size_t i = 0;
+
+  for(; i + 128 <= length; i += 128)
+  {
+    acc0 = _mm256_min_epu8(acc0, _mm256_loadu_si256((const __m256i *)(src+i)));
+    acc1 = _mm256_min_epu8(acc1, _mm256_loadu_si256((const __m256i *)(src+i+32)));
+    acc2 = _mm256_min_epu8(acc2, _mm256_loadu_si256((const __m256i *)(src+i+64)));
+    acc3 = _mm256_min_epu8(acc3, _mm256_loadu_si256((const __m256i *)(src+i+96)));
+  }
+  for(; i + 32 <= length; i += 32)
+  {
+    acc0 = _mm256_min_epu8(acc0, _mm256_loadu_si256((const __m256i *)(src+i)));
+  }
+
+  acc0 = _mm256_min_epu8(_mm256_min_epu8(acc0, acc1), _mm256_min_epu8(acc2, acc3));
+  minimum = reduce_min_128(_mm_min_epu8(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1)));
+  for(; i < length; ++i)
+  {
+    minimum = minimum > *(src+i) ? *(src+i) : minimum;
+  }
+
+  return minimum;
+}
+
+static AVX2_TARGET uint8_t avx2_maximum(const uint8_t * src, size_t length)
+{
+  __m256i acc0 = _mm256_setzero_si256();
+  __m256i acc1 = acc0;
+  __m256i acc2 = acc0;
+  __m256i acc3 = acc0;
+  uint8_t maximum;
+  size_t i = 0;
+
+  for(; i + 128 <= length; i += 128)
+  {
+    acc0 = _mm256_max_epu8(acc0, _mm256_loadu_si256((const __m256i *)(src+i)));
+    acc1 = _mm256_max_epu8(acc1, _mm256_loadu_si256((const __m256i *)(src+i+32)));
+    acc2 = _mm256_max_epu8(acc2, _mm256_loadu_si256((const __m256i *)(src+i+64)));
+    acc3 = _mm256_max_epu8(acc3, _mm256_loadu_si256((const __m256i *)(src+i+96)));
+  }
+  for(; i + 32 <= length; i += 32)
+  {
+    acc0 = _mm256_max_epu8(acc0, _mm256_loadu_si256((const __m256i *)(src+i)));
+  }
+
+  acc0 = _mm256_max_epu8(_mm256_max_epu8(acc0, acc1), _mm256_max_epu8(acc2, acc3));
+  maximum = reduce_max_128(_mm_max_epu8(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1)));
+  for(; i < length; ++i)
+  {
+    maximum = maximum < *(src+i) ? *(src+i) : maximum;
+  }
+
+  return maximum;
+}
+
+static AVX2_TARGET uint64_t avx2_sum(const uint8_t * src, size_t length)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i acc0 = zero;
+  __m256i acc1 = zero;
+  uint64_t sum_value;
+  size_t i = 0;
+
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(src+i)), zero));
+    acc1 = _mm256_add_epi64(acc1, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(src+i+32)), zero));
+  }
+  for(; i + 32 <= length; i += 32)
+  {
+    acc0 = _mm256_add_epi64(acc0, _mm256_sad_epu8(_mm256_loadu_si256((const __m256i *)(src+i)), zero));
+  }
+
+  acc0 = _mm256_add_epi64(acc0, acc1);
+  sum_value = reduce_sum_128(_mm_add_epi64(_mm256_castsi256_si128(acc0), _mm256_extracti128_si256(acc0, 1)));
+  for(; i < length; ++i)
+  {
+    sum_value += *(src+i);
+  }
+
+  return sum_value;
+}
+
+static AVX512BW_TARGET uint8_t avx512bw_minimum(const uint8_t * src, size_t length)
+{
+  const __m512i ones = _mm512_set1_epi8((char)0xFF);
+  __m512i acc0 = ones;
+  __m512i acc1 = ones;
+  __m256i half;
+  __mmask64 mask;
+  size_t i = 0;
+
+  for(; i + 128 <= length; i += 128)
+  {
+    acc0 = _mm512_min_epu8(acc0, _mm512_loadu_si512((const void *)(src+i)));
+    acc1 = _mm512_min_epu8(acc1, _mm512_loadu_si512((const void *)(src+i+64)));
+  }
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm512_min_epu8(acc0, _mm512_loadu_si512((const void *)(src+i)));
+  }
+  if(i < length)
+  {
+    /* Masked tail: missing lanes read as 0xFF and cannot lower the minimum */
+    mask = _cvtu64_mask64(~0ULL >> (64 - (length - i)));
+    acc1 = _mm512_min_epu8(acc1, _mm512_mask_loadu_epi8(ones, mask, (const void *)(src+i)));
+  }
+
+  acc0 = _mm512_min_epu8(acc0, acc1);
+  half = _mm256_min_epu8(_mm512_castsi512_si256(acc0), _mm512_extracti64x4_epi64(acc0, 1));
+  return reduce_min_128(_mm_min_epu8(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1)));
+}
+
+static AVX512BW_TARGET uint8_t avx512bw_maximum(const uint8_t * src, size_t length)
+{
+  __m512i acc0 = _mm512_setzero_si512();
+  __m512i acc1 = acc0;
+  __m256i half;
+  __mmask64 mask;
+  size_t i = 0;
+
+  for(; i + 128 <= length; i += 128)
+  {
+    acc0 = _mm512_max_epu8(acc0, _mm512_loadu_si512((const void *)(src+i)));
+    acc1 = _mm512_max_epu8(acc1, _mm512_loadu_si512((const void *)(src+i+64)));
+  }
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm512_max_epu8(acc0, _mm512_loadu_si512((const void *)(src+i)));
+  }
+  if(i < length)
+  {
+    /* Masked tail: missing lanes read as zero and cannot raise the maximum */
+    mask = _cvtu64_mask64(~0ULL >> (64 - (length - i)));
+    acc1 = _mm512_max_epu8(acc1, _mm512_maskz_loadu_epi8(mask, (const void *)(src+i)));
+  }
+
+  acc0 = _mm512_max_epu8(acc0, acc1);
+  half = _mm256_max_epu8(_mm512_castsi512_si256(acc0), _mm512_extracti64x4_epi64(acc0, 1));
+  return reduce_max_128(_mm_max_epu8(_mm256_castsi256_si128(half), _mm256_extracti128_si256(half, 1)));
+}
+
+static AVX512BW_TARGET uint64_t avx512bw_sum(const uint8_t * src, size_t length)
+{
+  const __m512i zero = _mm512_setzero_si512();
+  __m512i acc0 = zero;
+  __m512i acc1 = zero;
+  __mmask64 mask;
+  size_t i = 0;
+
+  for(; i + 128 <= length; i += 128)
+  {
+    acc0 = _mm512_add_epi64(acc0, _mm512_sad_epu8(_mm512_loadu_si512((const void *)(src+i)), zero));
+    acc1 = _mm512_add_epi64(acc1, _mm512_sad_epu8(_mm512_loadu_si512((const void *)(src+i+64)), zero));
+  }
+  for(; i + 64 <= length; i += 64)
+  {
+    acc0 = _mm512_add_epi64(acc0, _mm512_sad_epu8(_mm512_loadu_si512((const void *)(src+i)), zero));
+  }
+  if(i < length)
+  {
+    mask = _cvtu64_mask64(~0ULL >> (64 - (length - i)));
+    acc1 = _mm512_add_epi64(acc1, _mm512_sad_epu8(_mm512_maskz_loadu_epi8(mask, (const void *)(src+i)), zero));
+  }
+
+  return (uint64_t)_mm512_reduce_add_epi64(_mm512_add_epi64(acc0, acc1));
+}
+
+static void x86_histogram(const uint8_t * src, size_t length, size_t * histogram)
+{
+  size_t partial[4][256];
+  uint64_t word;
+  size_t i;
+
+  for(i = 0; i < 256; ++i)
+  {
+    partial[0][i] = 0;
+    partial[1][i] = 0;
+    partial[2][i] = 0;
+    partial[3][i] = 0;
+  }
+
+  for(i = 0; i + 8 <= length; i += 8)
+  {
+    memcpy(&word, src+i, sizeof(word));
+    ++partial[0][word & 0xFF];
+    ++partial[1][(word >> 8) & 0xFF];
+    ++partial[2][(word >> 16) & 0xFF];
+    ++partial[3][(word >> 24) & 0xFF];
+    ++partial[0][(word >> 32) & 0xFF];
+    ++partial[1][(word >> 40) & 0xFF];
+    ++partial[2][(word >> 48) & 0xFF];
+    ++partial[3][word >> 56];
+  }
+  for(; i < length; ++i)
+  {
+    ++partial[0][*(src+i)];
+  }
+
+  for(i = 0; i < 256; ++i)
+  {
+    *(histogram+i) = partial[0][i] + partial[1][i] + partial[2][i] + partial[3][i];
+  }
+}
+
+#endif /* KERNELS_X86 */
@@ -21,11 +21,15 @@
  *
  */
 #include "course1.h"
+#include "bench.h"
 
 /* A pretty boring main file */
 int main(void) {
 #ifdef COURSE1
   course1();
+#endif
+#ifdef BENCH
+  bench();
 #endif
   return 0;
 }
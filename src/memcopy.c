@@ -0,0 +1,749 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file memcopy.c
+ * @brief File containing the block copy engines and their dispatch.
+ *
+ * Every engine but the byte reference has the same three steps: bytes up to the first aligned
+ * destination address, a bulk loop that reads a whole block before writing it, and the tail, which
+ * is handed to the word engine. The source is never required to be aligned except by the multiple
+ * load/store engine, LDM and STM fault on misaligned addresses, so a source that cannot be aligned
+ * together with the destination is copied by the word engine. The x86 engines carry their own target
+ * attribute so the file builds with the default compiler flags.
+ *
+ * The streaming loops replace the aligned stores of the SSE2 engine with movntdq and end with an
+ * sfence, so the non-temporal stores are visible to other threads before the call returns. The cache
+ * size comes from the sysfs cache entries of the first CPU, the largest data or unified cache wins.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "memcopy.h"
+#include "parallel.h"
+
+#ifdef PARALLEL_THREADS
+#include <pthread.h>
+#endif
+
+#if defined (HOST)
+#include <stdio.h>
+
+/* Cache entries of the first CPU, numbered from 0 */
+#define MEMCOPY_SYSFS_CACHE "/sys/devices/system/cpu/cpu0/cache/index%u/%s"
+#define MEMCOPY_SYSFS_ENTRIES (16u)
+#endif
+
+#ifdef KERNELS_X86
+#include <immintrin.h>
+
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX_TARGET  __attribute__((target("avx")))
+#endif
+
+/* Widest integer the platform loads in one instruction, allowed to alias the bytes it is read from */
+#if defined (HOST)
+typedef uint64_t __attribute__((__may_alias__)) memcopy_word_t;
+#else
+typedef uint32_t __attribute__((__may_alias__)) memcopy_word_t;
+#endif
+
+/* Register of the multiple load/store bursts */
+typedef uint32_t __attribute__((__may_alias__)) memcopy_register_t;
+
+/* Bytes copied by one iteration of the word loop, four words read before any is written */
+#define MEMCOPY_WORD_BLOCK (4u * sizeof(memcopy_word_t))
+
+/* Bytes copied by one LDM/STM pair, four registers */
+#define MEMCOPY_LDM_BLOCK (4u * sizeof(memcopy_register_t))
+
+static memcopy_word_t load_word(const uint8_t * src);
+static size_t detect_cache_size(void);
+static void select_engine(void);
+static void read_cache_size(void);
+static void words_backward(const uint8_t * src, uint8_t * dst, size_t length);
+static void bytes_copy(const uint8_t * src, uint8_t * dst, size_t length);
+static void ldm_copy(const uint8_t * src, uint8_t * dst, size_t length);
+#ifdef KERNELS_X86
+static void sse2_copy(const uint8_t * src, uint8_t * dst, size_t length);
+static void avx_copy(const uint8_t * src, uint8_t * dst, size_t length);
+static void sse2_backward(const uint8_t * src, uint8_t * dst, size_t length);
+static void avx_backward(const uint8_t * src, uint8_t * dst, size_t length);
+static void sse2_stream(const uint8_t * src, uint8_t * dst, size_t length);
+static void sse2_stream_fill(uint8_t * dst, size_t length, uint8_t value);
+#endif
+
+const memcopy_engine_t memcopy_bytes =
+{
+  "bytes",
+  bytes_copy
+};
+
+const memcopy_engine_t memcopy_words =
+{
+  "words",
+  memcopy_forward
+};
+
+const memcopy_engine_t memcopy_ldm =
+{
+  "ldm",
+  ldm_copy
+};
+
+#ifdef KERNELS_X86
+const memcopy_engine_t memcopy_sse2 =
+{
+  "sse2",
+  sse2_copy
+};
+
+const memcopy_engine_t memcopy_avx =
+{
+  "avx",
+  avx_copy
+};
+#endif
+
+/* Engine selected by the dispatch, NULL until the first call to memcopy_get */
+static const memcopy_engine_t * selected_engine = NULL;
+
+/* Size of the last level cache, read by the first call to memcopy_cache_size */
+static size_t cache_size = 0;
+static uint8_t cache_detected = 0;
+
+#ifdef PARALLEL_THREADS
+/* The first calls may come from several threads at once, only one of them resolves each value */
+static pthread_once_t engine_once = PTHREAD_ONCE_INIT;
+static pthread_once_t cache_once = PTHREAD_ONCE_INIT;
+#endif
+
+/* Configured streaming threshold, 0 means the size of the last level cache */
+static size_t stream_threshold = 0;
+
+/* Function definition*/
+void memcopy_forward(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  memcopy_word_t w0;
+  memcopy_word_t w1;
+  memcopy_word_t w2;
+  memcopy_word_t w3;
+
+  /* Bytes up to the first aligned destination word, then whole words, then the tail */
+  while(length > 0 && (uintptr_t)dst % sizeof(memcopy_word_t) != 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+  while(length >= MEMCOPY_WORD_BLOCK)
+  {
+    w0 = load_word(src);
+    w1 = load_word(src + sizeof(memcopy_word_t));
+    w2 = load_word(src + 2 * sizeof(memcopy_word_t));
+    w3 = load_word(src + 3 * sizeof(memcopy_word_t));
+    *((memcopy_word_t *)dst) = w0;
+    *((memcopy_word_t *)dst + 1) = w1;
+    *((memcopy_word_t *)dst + 2) = w2;
+    *((memcopy_word_t *)dst + 3) = w3;
+    src += MEMCOPY_WORD_BLOCK;
+    dst += MEMCOPY_WORD_BLOCK;
+    length -= MEMCOPY_WORD_BLOCK;
+  }
+  while(length >= sizeof(memcopy_word_t))
+  {
+    *((memcopy_word_t *)dst) = load_word(src);
+    src += sizeof(memcopy_word_t);
+    dst += sizeof(memcopy_word_t);
+    length -= sizeof(memcopy_word_t);
+  }
+  while(length > 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+}
+
+void memcopy_backward(const uint8_t * src, uint8_t * dst, size_t length)
+{
+#ifdef KERNELS_X86
+  /* The vector loops follow the engine of memcopy_get, so they only run where the CPU supports them */
+  if(memcopy_get() == &memcopy_avx)
+  {
+    avx_backward(src, dst, length);
+    return;
+  }
+  if(memcopy_get() == &memcopy_sse2)
+  {
+    sse2_backward(src, dst, length);
+    return;
+  }
+#endif
+  words_backward(src, dst, length);
+}
+
+void memcopy_fill(uint8_t * dst, size_t length, uint8_t value)
+{
+  /* The value repeated in every byte of a word */
+  memcopy_word_t word = (memcopy_word_t)(((memcopy_word_t)~(memcopy_word_t)0 / 0xFFu) * value);
+
+  while(length > 0 && (uintptr_t)dst % sizeof(memcopy_word_t) != 0)
+  {
+    *dst++ = value;
+    length--;
+  }
+  while(length >= MEMCOPY_WORD_BLOCK)
+  {
+    *((memcopy_word_t *)dst) = word;
+    *((memcopy_word_t *)dst + 1) = word;
+    *((memcopy_word_t *)dst + 2) = word;
+    *((memcopy_word_t *)dst + 3) = word;
+    dst += MEMCOPY_WORD_BLOCK;
+    length -= MEMCOPY_WORD_BLOCK;
+  }
+  while(length >= sizeof(memcopy_word_t))
+  {
+    *((memcopy_word_t *)dst) = word;
+    dst += sizeof(memcopy_word_t);
+    length -= sizeof(memcopy_word_t);
+  }
+  while(length > 0)
+  {
+    *dst++ = value;
+    length--;
+  }
+}
+
+void memcopy_stream(const uint8_t * src, uint8_t * dst, size_t length)
+{
+#ifdef KERNELS_X86
+  if(memcopy_supported(&memcopy_sse2))
+  {
+    sse2_stream(src, dst, length);
+    return;
+  }
+#endif
+  memcopy_get()->copy(src, dst, length);
+}
+
+void memcopy_stream_fill(uint8_t * dst, size_t length, uint8_t value)
+{
+#ifdef KERNELS_X86
+  if(memcopy_supported(&memcopy_sse2))
+  {
+    sse2_stream_fill(dst, length, value);
+    return;
+  }
+#endif
+  memcopy_fill(dst, length, value);
+}
+
+size_t memcopy_cache_size(void)
+{
+#ifdef PARALLEL_THREADS
+  pthread_once(&cache_once, read_cache_size);
+#else
+  if(! cache_detected)
+  {
+    read_cache_size();
+  }
+#endif
+
+  return cache_size;
+}
+
+void memcopy_set_stream_threshold(size_t min_size)
+{
+  stream_threshold = min_size;
+}
+
+size_t memcopy_get_stream_threshold(void)
+{
+  if(stream_threshold != 0)
+  {
+    return stream_threshold;
+  }
+
+  /* Without a cache to protect nothing is worth streaming */
+  return memcopy_cache_size() != 0 ? memcopy_cache_size() : SIZE_MAX;
+}
+
+const memcopy_engine_t * memcopy_get(void)
+{
+#ifdef PARALLEL_THREADS
+  pthread_once(&engine_once, select_engine);
+#else
+  if(selected_engine == NULL)
+  {
+    select_engine();
+  }
+#endif
+
+  return selected_engine;
+}
+
+int8_t memcopy_supported(const memcopy_engine_t * engine)
+{
+  if(engine == &memcopy_bytes || engine == &memcopy_words || engine == &memcopy_ldm)
+  {
+    return 1;
+  }
+#ifdef KERNELS_X86
+  __builtin_cpu_init();
+  if(engine == &memcopy_sse2)
+  {
+    return __builtin_cpu_supports("sse2") ? 1 : 0;
+  }
+  if(engine == &memcopy_avx)
+  {
+    return __builtin_cpu_supports("avx") ? 1 : 0;
+  }
+#endif
+  return 0;
+}
+
+size_t memcopy_available(const memcopy_engine_t ** list, size_t max_size)
+{
+  const memcopy_engine_t * candidates[] =
+  {
+    &memcopy_bytes,
+    &memcopy_words,
+    &memcopy_ldm,
+#ifdef KERNELS_X86
+    &memcopy_sse2,
+    &memcopy_avx,
+#endif
+  };
+  size_t count = 0;
+  size_t i;
+
+  for(i = 0; i < sizeof(candidates) / sizeof(candidates[0]) && count < max_size; ++i)
+  {
+    if(memcopy_supported(candidates[i]))
+    {
+      *(list+count) = candidates[i];
+      ++count;
+    }
+  }
+
+  return count;
+}
+
+static memcopy_word_t load_word(const uint8_t * src)
+{
+  memcopy_word_t word;
+
+  /* The source may be misaligned, a fixed size copy compiles to a single unaligned load */
+  memcpy(&word, src, sizeof(memcopy_word_t));
+  return word;
+}
+
+static void words_backward(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  memcopy_word_t w0;
+  memcopy_word_t w1;
+  memcopy_word_t w2;
+  memcopy_word_t w3;
+
+  /* Same steps as memcopy_forward, from the ends of both blocks */
+  src += length;
+  dst += length;
+  while(length > 0 && (uintptr_t)dst % sizeof(memcopy_word_t) != 0)
+  {
+    *--dst = *--src;
+    length--;
+  }
+  while(length >= MEMCOPY_WORD_BLOCK)
+  {
+    src -= MEMCOPY_WORD_BLOCK;
+    dst -= MEMCOPY_WORD_BLOCK;
+    w3 = load_word(src + 3 * sizeof(memcopy_word_t));
+    w2 = load_word(src + 2 * sizeof(memcopy_word_t));
+    w1 = load_word(src + sizeof(memcopy_word_t));
+    w0 = load_word(src);
+    *((memcopy_word_t *)dst + 3) = w3;
+    *((memcopy_word_t *)dst + 2) = w2;
+    *((memcopy_word_t *)dst + 1) = w1;
+    *((memcopy_word_t *)dst) = w0;
+    length -= MEMCOPY_WORD_BLOCK;
+  }
+  while(length >= sizeof(memcopy_word_t))
+  {
+    src -= sizeof(memcopy_word_t);
+    dst -= sizeof(memcopy_word_t);
+    *((memcopy_word_t *)dst) = load_word(src);
+    length -= sizeof(memcopy_word_t);
+  }
+  while(length > 0)
+  {
+    *--dst = *--src;
+    length--;
+  }
+}
+
+static void select_engine(void)
+{
+#if defined (MSP432)
+  selected_engine = &memcopy_ldm;
+#elif defined (KERNELS_X86)
+  /* From the widest to the narrowest instruction set */
+  if(memcopy_supported(&memcopy_avx))
+  {
+    selected_engine = &memcopy_avx;
+  }
+  else if(memcopy_supported(&memcopy_sse2))
+  {
+    selected_engine = &memcopy_sse2;
+  }
+  else
+  {
+    selected_engine = &memcopy_words;
+  }
+#else
+  selected_engine = &memcopy_words;
+#endif
+}
+
+static void read_cache_size(void)
+{
+  cache_size = detect_cache_size();
+  cache_detected = 1;
+}
+
+static size_t detect_cache_size(void)
+{
+#if defined (HOST)
+  char path[128];
+  char type[32];
+  char unit;
+  size_t size;
+  size_t largest = 0;
+  unsigned int index;
+  FILE * file;
+
+  for(index = 0; index < MEMCOPY_SYSFS_ENTRIES; ++index)
+  {
+    snprintf(path, sizeof(path), MEMCOPY_SYSFS_CACHE, index, "type");
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+      break;
+    }
+    if(fscanf(file, "%31s", type) != 1)
+    {
+      type[0] = '\0';
+    }
+    fclose(file);
+    if(strcmp(type, "Data") != 0 && strcmp(type, "Unified") != 0)
+    {
+      continue;
+    }
+
+    /* Sizes are written like 32K or 8M */
+    snprintf(path, sizeof(path), MEMCOPY_SYSFS_CACHE, index, "size");
+    file = fopen(path, "r");
+    if(file == NULL)
+    {
+      continue;
+    }
+    unit = 'B';
+    if(fscanf(file, "%zu%c", &size, &unit) >= 1)
+    {
+      size = unit == 'K' ? size * 1024u : unit == 'M' ? size * 1024u * 1024u : size;
+      largest = size > largest ? size : largest;
+    }
+    fclose(file);
+  }
+
+  return largest != 0 ? largest : MEMCOPY_DEFAULT_CACHE_B;
+#else
+  return 0;
+#endif
+}
+
+static void bytes_copy(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  size_t i;
+
+  for(i = 0; i < length; ++i)
+  {
+    *(dst+i) = *(src+i);
+  }
+}
+
+static void ldm_copy(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  const memcopy_register_t * src_word;
+  memcopy_register_t * dst_word;
+#if !defined (MSP432)
+  memcopy_register_t r0;
+  memcopy_register_t r1;
+  memcopy_register_t r2;
+  memcopy_register_t r3;
+#endif
+
+  /* Both blocks must reach a word boundary at the same byte */
+  if(((uintptr_t)src ^ (uintptr_t)dst) % sizeof(memcopy_register_t) != 0)
+  {
+    memcopy_forward(src, dst, length);
+    return;
+  }
+
+  while(length > 0 && (uintptr_t)dst % sizeof(memcopy_register_t) != 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+  src_word = (const memcopy_register_t *)src;
+  dst_word = (memcopy_register_t *)dst;
+  while(length >= MEMCOPY_LDM_BLOCK)
+  {
+#if defined (MSP432)
+    /* r7 is the frame pointer in Thumb code, the burst stays below it */
+    __asm__ volatile ("ldmia %0!, {r3-r6}\n\t"
+                      "stmia %1!, {r3-r6}"
+                      : "+r" (src_word), "+r" (dst_word)
+                      :
+                      : "r3", "r4", "r5", "r6", "memory");
+#else
+    r0 = *src_word;
+    r1 = *(src_word+1);
+    r2 = *(src_word+2);
+    r3 = *(src_word+3);
+    *dst_word = r0;
+    *(dst_word+1) = r1;
+    *(dst_word+2) = r2;
+    *(dst_word+3) = r3;
+    src_word += 4;
+    dst_word += 4;
+#endif
+    length -= MEMCOPY_LDM_BLOCK;
+  }
+
+  memcopy_forward((const uint8_t *)src_word, (uint8_t *)dst_word, length);
+}
+
+#ifdef KERNELS_X86
+SSE2_TARGET static void sse2_copy(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  __m128i v0;
+  __m128i v1;
+  __m128i v2;
+  __m128i v3;
+
+  /* Aligned stores, unaligned loads, four vectors per iteration */
+  while(length > 0 && (uintptr_t)dst % sizeof(__m128i) != 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m128i))
+  {
+    v0 = _mm_loadu_si128((const __m128i *)src);
+    v1 = _mm_loadu_si128((const __m128i *)src + 1);
+    v2 = _mm_loadu_si128((const __m128i *)src + 2);
+    v3 = _mm_loadu_si128((const __m128i *)src + 3);
+    _mm_store_si128((__m128i *)dst, v0);
+    _mm_store_si128((__m128i *)dst + 1, v1);
+    _mm_store_si128((__m128i *)dst + 2, v2);
+    _mm_store_si128((__m128i *)dst + 3, v3);
+    src += 4 * sizeof(__m128i);
+    dst += 4 * sizeof(__m128i);
+    length -= 4 * sizeof(__m128i);
+  }
+  while(length >= sizeof(__m128i))
+  {
+    _mm_store_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+    src += sizeof(__m128i);
+    dst += sizeof(__m128i);
+    length -= sizeof(__m128i);
+  }
+
+  memcopy_forward(src, dst, length);
+}
+
+AVX_TARGET static void avx_copy(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  __m256i v0;
+  __m256i v1;
+  __m256i v2;
+  __m256i v3;
+
+  while(length > 0 && (uintptr_t)dst % sizeof(__m256i) != 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m256i))
+  {
+    v0 = _mm256_loadu_si256((const __m256i *)src);
+    v1 = _mm256_loadu_si256((const __m256i *)src + 1);
+    v2 = _mm256_loadu_si256((const __m256i *)src + 2);
+    v3 = _mm256_loadu_si256((const __m256i *)src + 3);
+    _mm256_store_si256((__m256i *)dst, v0);
+    _mm256_store_si256((__m256i *)dst + 1, v1);
+    _mm256_store_si256((__m256i *)dst + 2, v2);
+    _mm256_store_si256((__m256i *)dst + 3, v3);
+    src += 4 * sizeof(__m256i);
+    dst += 4 * sizeof(__m256i);
+    length -= 4 * sizeof(__m256i);
+  }
+  while(length >= sizeof(__m256i))
+  {
+    _mm256_store_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+    src += sizeof(__m256i);
+    dst += sizeof(__m256i);
+    length -= sizeof(__m256i);
+  }
+
+  /* Clear the upper halves before running SSE code again */
+  _mm256_zeroupper();
+  memcopy_forward(src, dst, length);
+}
+
+SSE2_TARGET static void sse2_backward(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  __m128i v0;
+  __m128i v1;
+  __m128i v2;
+  __m128i v3;
+
+  /* Same steps as sse2_copy from the ends of both blocks, the start is handed to the word loop */
+  src += length;
+  dst += length;
+  while(length > 0 && (uintptr_t)dst % sizeof(__m128i) != 0)
+  {
+    *--dst = *--src;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m128i))
+  {
+    src -= 4 * sizeof(__m128i);
+    dst -= 4 * sizeof(__m128i);
+    v3 = _mm_loadu_si128((const __m128i *)src + 3);
+    v2 = _mm_loadu_si128((const __m128i *)src + 2);
+    v1 = _mm_loadu_si128((const __m128i *)src + 1);
+    v0 = _mm_loadu_si128((const __m128i *)src);
+    _mm_store_si128((__m128i *)dst + 3, v3);
+    _mm_store_si128((__m128i *)dst + 2, v2);
+    _mm_store_si128((__m128i *)dst + 1, v1);
+    _mm_store_si128((__m128i *)dst, v0);
+    length -= 4 * sizeof(__m128i);
+  }
+  while(length >= sizeof(__m128i))
+  {
+    src -= sizeof(__m128i);
+    dst -= sizeof(__m128i);
+    _mm_store_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+    length -= sizeof(__m128i);
+  }
+
+  words_backward(src - length, dst - length, length);
+}
+
+AVX_TARGET static void avx_backward(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  __m256i v0;
+  __m256i v1;
+  __m256i v2;
+  __m256i v3;
+
+  src += length;
+  dst += length;
+  while(length > 0 && (uintptr_t)dst % sizeof(__m256i) != 0)
+  {
+    *--dst = *--src;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m256i))
+  {
+    src -= 4 * sizeof(__m256i);
+    dst -= 4 * sizeof(__m256i);
+    v3 = _mm256_loadu_si256((const __m256i *)src + 3);
+    v2 = _mm256_loadu_si256((const __m256i *)src + 2);
+    v1 = _mm256_loadu_si256((const __m256i *)src + 1);
+    v0 = _mm256_loadu_si256((const __m256i *)src);
+    _mm256_store_si256((__m256i *)dst + 3, v3);
+    _mm256_store_si256((__m256i *)dst + 2, v2);
+    _mm256_store_si256((__m256i *)dst + 1, v1);
+    _mm256_store_si256((__m256i *)dst, v0);
+    length -= 4 * sizeof(__m256i);
+  }
+  while(length >= sizeof(__m256i))
+  {
+    src -= sizeof(__m256i);
+    dst -= sizeof(__m256i);
+    _mm256_store_si256((__m256i *)dst, _mm256_loadu_si256((const __m256i *)src));
+    length -= sizeof(__m256i);
+  }
+
+  _mm256_zeroupper();
+  words_backward(src - length, dst - length, length);
+}
+
+SSE2_TARGET static void sse2_stream(const uint8_t * src, uint8_t * dst, size_t length)
+{
+  __m128i v0;
+  __m128i v1;
+  __m128i v2;
+  __m128i v3;
+
+  /* Same loop as sse2_copy, the aligned stores become non-temporal */
+  while(length > 0 && (uintptr_t)dst % sizeof(__m128i) != 0)
+  {
+    *dst++ = *src++;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m128i))
+  {
+    v0 = _mm_loadu_si128((const __m128i *)src);
+    v1 = _mm_loadu_si128((const __m128i *)src + 1);
+    v2 = _mm_loadu_si128((const __m128i *)src + 2);
+    v3 = _mm_loadu_si128((const __m128i *)src + 3);
+    _mm_stream_si128((__m128i *)dst, v0);
+    _mm_stream_si128((__m128i *)dst + 1, v1);
+    _mm_stream_si128((__m128i *)dst + 2, v2);
+    _mm_stream_si128((__m128i *)dst + 3, v3);
+    src += 4 * sizeof(__m128i);
+    dst += 4 * sizeof(__m128i);
+    length -= 4 * sizeof(__m128i);
+  }
+  _mm_sfence();
+
+  memcopy_forward(src, dst, length);
+}
+
+SSE2_TARGET static void sse2_stream_fill(uint8_t * dst, size_t length, uint8_t value)
+{
+  __m128i v = _mm_set1_epi8((char)value);
+
+  while(length > 0 && (uintptr_t)dst % sizeof(__m128i) != 0)
+  {
+    *dst++ = value;
+    length--;
+  }
+  while(length >= 4 * sizeof(__m128i))
+  {
+    _mm_stream_si128((__m128i *)dst, v);
+    _mm_stream_si128((__m128i *)dst + 1, v);
+    _mm_stream_si128((__m128i *)dst + 2, v);
+    _mm_stream_si128((__m128i *)dst + 3, v);
+    dst += 4 * sizeof(__m128i);
+    length -= 4 * sizeof(__m128i);
+  }
+  _mm_sfence();
+
+  memcopy_fill(dst, length, value);
+}
+#endif
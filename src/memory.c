@@ -16,6 +16,11 @@
  * writing to memory via function calls. There is also a globally
  * allocated buffer array used for manipulation.
  *
+ * Every pool block is preceded by a header holding its class, so free_words
+ * knows where the block goes back. Free blocks keep the link of their free
+ * list in their payload. When a chunk is too short for the next block, the
+ * rest of it is cut into blocks of the smaller classes, so nothing is lost.
+ *
  * @author Alex Fosdick
  * @date April 1 2017
  *
@@ -23,11 +28,71 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include "memory.h"
+#include "memcopy.h"
+#include "parallel.h"
+
+#ifdef PARALLEL_THREADS
+#include <pthread.h>
+#endif
+
+#if defined (MSP432)
+#include <errno.h>
+
+/* Bounds of the newlib heap from the linker script, it starts after the pool and ends below the stack */
+extern unsigned char end;
+extern unsigned char __HeapLimit;
+
+void * _sbrk(ptrdiff_t increment);
+#endif
+
+/* Bytes in front of every block, a multiple of the 8-byte alignment */
+#define MEMORY_POOL_HEADER (8u)
+
+/* Class stored in the header of the blocks that come from malloc */
+#define MEMORY_POOL_LARGE (MEMORY_POOL_CLASSES)
+
+/* Free block of the pool, the link lives in the payload */
+typedef struct memory_free_block
+{
+  struct memory_free_block * next;
+} memory_free_block_t;
+
+static void * pool_alloc(size_t bytes);
+static void pool_free(void * payload);
+static unsigned char * pool_carve(size_t size_class);
+static void pool_spill(void);
+
+/* Write hook of the setters and its context */
+static memory_write_hook_t write_hook = NULL;
+static void * write_hook_context = NULL;
+
+/* Free list of every class and the rest of the current chunk */
+static memory_free_block_t * free_lists[MEMORY_POOL_CLASSES];
+static unsigned char * chunk_next = NULL;
+static size_t chunk_left = 0;
+
+#ifdef MEMORY_POOL_HEAP
+/* The only chunk, sized here and placed by the linker script in its own region below the newlib heap */
+static uint64_t memory_heap[MEMORY_HEAP_SIZE / sizeof(uint64_t)] __attribute__((section(".pool")));
+static uint8_t memory_heap_taken = 0;
+#endif
+
+#ifdef PARALLEL_THREADS
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
 
 /***********************************************************
  Function Definitions
 ***********************************************************/
+void memory_set_write_hook(memory_write_hook_t hook, void * context){
+  write_hook = hook;
+  write_hook_context = context;
+}
+
 void set_value(char * ptr, unsigned int index, char value){
+  if(write_hook != NULL){
+    write_hook(write_hook_context, ptr, index, value);
+  }
   ptr[index] = value;
 }
 
@@ -51,43 +116,55 @@ void clear_all(char * ptr, unsigned int size){
 }
 
 uint8_t * my_memmove(uint8_t * src, uint8_t * dst, size_t length){
-  unsigned int i;
-  uint8_t* tmp;
   if(src == NULL || dst == NULL){
     return NULL;
   }
-  tmp = (uint8_t *)malloc(sizeof(uint8_t ) * length);
 
-  for(i = 0; i < length; i++){
-    *(tmp+i) = *(src+i);
+  /* Blocks that do not overlap take the fastest engine. Otherwise copying towards lower addresses
+     never overwrites bytes that were not read yet, nor does copying backwards towards higher
+     addresses, so the direction is the only overlap handling */
+  if((uintptr_t)dst - (uintptr_t)src >= length && (uintptr_t)src - (uintptr_t)dst >= length){
+    memcopy_get()->copy(src, dst, length);
   }
-
-  for(i = 0; i < length; i++){
-    *(dst+i) = *(tmp+i);
+  else if((uintptr_t)dst <= (uintptr_t)src){
+    memcopy_forward(src, dst, length);
+  }
+  else{
+    memcopy_backward(src, dst, length);
   }
-  free(tmp);
   return dst;
 }
 
-
 uint8_t * my_memcopy(uint8_t * src, uint8_t * dst, size_t length){
-  unsigned int i;
   if(src == NULL || dst == NULL){
     return NULL;
   }
-  for(i = 0; i < length; i++){
-    *(dst+i) = *(src+i);
+  if(length >= memcopy_get_stream_threshold()){
+    memcopy_stream(src, dst, length);
+  }
+  else{
+    memcopy_get()->copy(src, dst, length);
   }
   return dst;
 }
 
+uint8_t * my_memcopy_reference(uint8_t * src, uint8_t * dst, size_t length){
+  if(src == NULL || dst == NULL){
+    return NULL;
+  }
+  memcopy_bytes.copy(src, dst, length);
+  return dst;
+}
+
 uint8_t * my_memset(uint8_t * src, size_t length, uint8_t value){
-  unsigned int i;
   if(src == NULL){
     return NULL;
   }
-  for(i = 0; i < length; i++){
-    *(src+i) = value;
+  if(length >= memcopy_get_stream_threshold()){
+    memcopy_stream_fill(src, length, value);
+  }
+  else{
+    memcopy_fill(src, length, value);
   }
   return src; 
 }
@@ -97,33 +174,150 @@ uint8_t * my_memzero(uint8_t * src, size_t length){
 }
 
 uint8_t * my_reverse(uint8_t * src, size_t length){
-  unsigned int i;
-  uint8_t* tmp;
+  size_t i;
+  uint8_t tmp;
 
   if(src == NULL){
     return NULL;
   }
-  tmp = (uint8_t *)malloc(sizeof(uint8_t ) * length);
-
-  for(i = 0; i < length; i++){
-    *(tmp+(length-1)-i) = *(src+i);
-  }
 
-  for(i = 0; i < length; i++){
-    *(src+i) = *(tmp+i);
+  /* Swap the ends towards the middle, no temporary block is needed */
+  for(i = 0; i < length / 2; i++){
+    tmp = *(src+i);
+    *(src+i) = *(src+(length-1)-i);
+    *(src+(length-1)-i) = tmp;
   }
-  free(tmp);
   return src;
 
 }
 
 int32_t * reserve_words(size_t length){
   int32_t* my_word;
-  my_word = (int32_t *)malloc(sizeof(int32_t ) * length);
+
+  if(length > ((size_t)-1 - MEMORY_POOL_HEADER) / sizeof(int32_t)){
+    return NULL;
+  }
+#ifdef PARALLEL_THREADS
+  pthread_mutex_lock(&pool_lock);
+#endif
+  my_word = (int32_t *)pool_alloc(sizeof(int32_t ) * length);
+#ifdef PARALLEL_THREADS
+  pthread_mutex_unlock(&pool_lock);
+#endif
 
   return my_word;
 }
 
 void free_words(int32_t * src){
-  free(src);
-}
\ No newline at end of file
+  if(src == NULL){
+    return;
+  }
+#ifdef PARALLEL_THREADS
+  pthread_mutex_lock(&pool_lock);
+#endif
+  pool_free(src);
+#ifdef PARALLEL_THREADS
+  pthread_mutex_unlock(&pool_lock);
+#endif
+}
+
+#if defined (MSP432)
+void * _sbrk(ptrdiff_t increment){
+  static unsigned char * heap_top = &end;
+  unsigned char * previous = heap_top;
+
+  /* malloc must neither reach the stack nor go back below the pool */
+  if((increment > 0 && increment > &__HeapLimit - heap_top) || (increment < 0 && -increment > heap_top - &end)){
+    errno = ENOMEM;
+    return (void *)-1;
+  }
+  heap_top += increment;
+  return previous;
+}
+#endif
+
+static void * pool_alloc(size_t bytes){
+  size_t size_class = 0;
+  unsigned char * block;
+
+  while(size_class < MEMORY_POOL_CLASSES && (MEMORY_POOL_MIN_BLOCK << size_class) < bytes){
+    size_class++;
+  }
+
+  if(size_class == MEMORY_POOL_LARGE){
+#ifdef MEMORY_POOL_HEAP
+    return NULL;
+#else
+    block = (unsigned char *)malloc(MEMORY_POOL_HEADER + bytes);
+#endif
+  }
+  else if(free_lists[size_class] != NULL){
+    block = (unsigned char *)free_lists[size_class] - MEMORY_POOL_HEADER;
+    free_lists[size_class] = free_lists[size_class]->next;
+  }
+  else{
+    block = pool_carve(size_class);
+  }
+
+  if(block == NULL){
+    return NULL;
+  }
+  *(uint32_t *)block = (uint32_t)size_class;
+  return block + MEMORY_POOL_HEADER;
+}
+
+static void pool_free(void * payload){
+  unsigned char * block = (unsigned char *)payload - MEMORY_POOL_HEADER;
+  memory_free_block_t * node = (memory_free_block_t *)payload;
+  uint32_t size_class = *(uint32_t *)block;
+
+  if(size_class == MEMORY_POOL_LARGE){
+    free(block);
+    return;
+  }
+  node->next = free_lists[size_class];
+  free_lists[size_class] = node;
+}
+
+static unsigned char * pool_carve(size_t size_class){
+  size_t need = MEMORY_POOL_HEADER + (MEMORY_POOL_MIN_BLOCK << size_class);
+  unsigned char * block;
+
+  if(chunk_left < need){
+    pool_spill();
+#ifdef MEMORY_POOL_HEAP
+    if(memory_heap_taken){
+      return NULL;
+    }
+    memory_heap_taken = 1;
+    chunk_next = (unsigned char *)memory_heap;
+    chunk_left = sizeof(memory_heap);
+#else
+    chunk_next = (unsigned char *)malloc(MEMORY_POOL_CHUNK);
+    chunk_left = chunk_next != NULL ? MEMORY_POOL_CHUNK : 0;
+#endif
+    if(chunk_left < need){
+      return NULL;
+    }
+  }
+
+  block = chunk_next;
+  chunk_next += need;
+  chunk_left -= need;
+  return block;
+}
+
+static void pool_spill(void){
+  size_t size_class = MEMORY_POOL_CLASSES;
+  unsigned char * block;
+
+  /* Largest classes first, every block still fits since the sizes only decrease */
+  while(size_class > 0){
+    size_class--;
+    while(chunk_left >= MEMORY_POOL_HEADER + (MEMORY_POOL_MIN_BLOCK << size_class)){
+      block = pool_carve(size_class);
+      *(uint32_t *)block = (uint32_t)size_class;
+      pool_free(block + MEMORY_POOL_HEADER);
+    }
+  }
+}
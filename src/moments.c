@@ -0,0 +1,116 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file moments.c
+ * @brief File containing the definition of the mergeable central moments.
+ *
+ * A block is first turned into central moments around its own mean, then merged. The merge only
+ * involves the difference of the two means and the lower moments, so no large power sum of the
+ * whole data set is ever formed and there is no catastrophic cancellation.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "moments.h"
+
+/* Function definition*/
+void moments_init(stats_moments_t * moments)
+{
+  moments->count = 0;
+  moments->mean = 0.0;
+  moments->m2 = 0.0;
+  moments->m3 = 0.0;
+  moments->m4 = 0.0;
+}
+
+void moments_add_block(stats_moments_t * moments, uint64_t count, double shift,
+                       double s1, double s2, double s3, double s4)
+{
+  stats_moments_t block;
+  double n = (double)count;
+  double d;
+
+  if(count == 0)
+  {
+    return;
+  }
+
+  /* Central moments of the block from its power sums around the shift */
+  d = s1 / n;
+  block.count = count;
+  block.mean = shift + d;
+  block.m2 = s2 - d * s1;
+  block.m3 = s3 - 3.0 * d * s2 + 2.0 * d * d * s1;
+  block.m4 = s4 - 4.0 * d * s3 + 6.0 * d * d * s2 - 3.0 * d * d * d * s1;
+
+  moments_merge(moments, &block);
+}
+
+void moments_merge(stats_moments_t * dst, const stats_moments_t * src)
+{
+  double na = (double)dst->count;
+  double nb = (double)src->count;
+  double n = na + nb;
+  double delta = src->mean - dst->mean;
+  double delta_n = delta / n;
+  double m2 = dst->m2;
+  double m3 = dst->m3;
+
+  if(src->count == 0)
+  {
+    return;
+  }
+
+  dst->m4 += src->m4 + delta * delta_n * delta_n * delta_n * na * nb * (na * na - na * nb + nb * nb)
+             + 6.0 * delta_n * delta_n * (na * na * src->m2 + nb * nb * m2)
+             + 4.0 * delta_n * (na * src->m3 - nb * m3);
+  dst->m3 += src->m3 + delta * delta_n * delta_n * na * nb * (na - nb)
+             + 3.0 * delta_n * (na * src->m2 - nb * m2);
+  dst->m2 += src->m2 + delta * delta_n * na * nb;
+  dst->mean += delta_n * nb;
+  dst->count += src->count;
+}
+
+double moments_variance(const stats_moments_t * moments)
+{
+  if(moments->count == 0)
+  {
+    return 0.0;
+  }
+  return moments->m2 / (double)moments->count;
+}
+
+double moments_skewness(const stats_moments_t * moments)
+{
+  double variance = moments_variance(moments);
+
+  if(variance <= 0.0)
+  {
+    return 0.0;
+  }
+  return moments->m3 / (double)moments->count / (variance * sqrt(variance));
+}
+
+double moments_kurtosis(const stats_moments_t * moments)
+{
+  double variance = moments_variance(moments);
+
+  if(variance <= 0.0)
+  {
+    return 0.0;
+  }
+  return moments->m4 / (double)moments->count / (variance * variance) - 3.0;
+}
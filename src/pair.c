@@ -0,0 +1,156 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file pair.c
+ * @brief File containing the definition of the two-array statistics kernels.
+ *
+ * The template below is expanded once per sample type. Both arrays are processed in blocks of
+ * PAIR_BLOCK samples with one branch-free loop per block that accumulates the five sums of x, y,
+ * x*x, y*y and x*y around the first pair of the block. The accumulator is a 32-bit integer for
+ * 8-bit samples and a 64-bit integer for 16-bit samples, which holds the sums of a block exactly
+ * and vectorizes, and a double for the other types. Every block is then merged into the running
+ * means and co-moments with the pairwise update used by moments.h, so the sums stay small and
+ * accurate on long arrays.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "pair.h"
+
+/* Pairs per block, the 8-bit sums of a block fit in 24 bits */
+#define PAIR_BLOCK (256)
+
+/* Running means and sums of the squared and crossed differences from the means */
+typedef struct
+{
+  double count;
+  double mean_x;
+  double mean_y;
+  double m2_x;
+  double m2_y;
+  double c_xy;
+} pair_state_t;
+
+static void pair_add_block(pair_state_t * state, size_t count, double shift_x, double shift_y,
+                           double s_x, double s_y, double s_xx, double s_yy, double s_xy);
+static stats_pair_t pair_finish(const pair_state_t * state);
+
+/* Defines the kernel stats_pair_<suffix> declared by PAIR_DECLARE */
+#define PAIR_DEFINE(suffix, type, acc_type)                                                     \
+stats_pair_t stats_pair_##suffix(const type * x, const type * y, size_t array_size)             \
+{                                                                                               \
+  pair_state_t state = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};                                          \
+  acc_type shift_x;                                                                             \
+  acc_type shift_y;                                                                             \
+  acc_type dx;                                                                                  \
+  acc_type dy;                                                                                  \
+  acc_type s_x;                                                                                 \
+  acc_type s_y;                                                                                 \
+  acc_type s_xx;                                                                                \
+  acc_type s_yy;                                                                                \
+  acc_type s_xy;                                                                                \
+  size_t start;                                                                                 \
+  size_t end;                                                                                   \
+  size_t i;                                                                                     \
+                                                                                                \
+  if(x == NULL || y == NULL)                                                                    \
+  {                                                                                             \
+    array_size = 0;                                                                             \
+  }                                                                                             \
+                                                                                                \
+  for(start = 0; start < array_size; start = end)                                              \
+  {                                                                                             \
+    end = array_size - start > PAIR_BLOCK ? start + PAIR_BLOCK : array_size;                    \
+    shift_x = (acc_type)*(x+start);                                                             \
+    shift_y = (acc_type)*(y+start);                                                             \
+    s_x = 0;                                                                                    \
+    s_y = 0;                                                                                    \
+    s_xx = 0;                                                                                   \
+    s_yy = 0;                                                                                   \
+    s_xy = 0;                                                                                   \
+    for(i = start; i < end; ++i)                                                                \
+    {                                                                                           \
+      dx = (acc_type)*(x+i) - shift_x;                                                          \
+      dy = (acc_type)*(y+i) - shift_y;                                                          \
+      s_x += dx;                                                                                \
+      s_y += dy;                                                                                \
+      s_xx += dx * dx;                                                                          \
+      s_yy += dy * dy;                                                                          \
+      s_xy += dx * dy;                                                                          \
+    }                                                                                           \
+    pair_add_block(&state, end - start, (double)shift_x, (double)shift_y,                       \
+                   (double)s_x, (double)s_y, (double)s_xx, (double)s_yy, (double)s_xy);         \
+  }                                                                                             \
+                                                                                                \
+  return pair_finish(&state);                                                                   \
+}
+
+/* Function definition*/
+PAIR_DEFINE(u8, uint8_t, int32_t)
+PAIR_DEFINE(u16, uint16_t, int64_t)
+PAIR_DEFINE(i32, int32_t, double)
+PAIR_DEFINE(f32, float, double)
+PAIR_DEFINE(f64, double, double)
+
+static void pair_add_block(pair_state_t * state, size_t count, double shift_x, double shift_y,
+                           double s_x, double s_y, double s_xx, double s_yy, double s_xy)
+{
+  double nb = (double)count;
+  double na = state->count;
+  double n = na + nb;
+  double mean_x = shift_x + s_x / nb;
+  double mean_y = shift_y + s_y / nb;
+  double delta_x = mean_x - state->mean_x;
+  double delta_y = mean_y - state->mean_y;
+  double weight = na * nb / n;
+
+  state->m2_x += s_xx - s_x * s_x / nb + delta_x * delta_x * weight;
+  state->m2_y += s_yy - s_y * s_y / nb + delta_y * delta_y * weight;
+  state->c_xy += s_xy - s_x * s_y / nb + delta_x * delta_y * weight;
+  state->mean_x += delta_x * nb / n;
+  state->mean_y += delta_y * nb / n;
+  state->count = n;
+}
+
+static stats_pair_t pair_finish(const pair_state_t * state)
+{
+  stats_pair_t pair = {0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+
+  if(state->count == 0.0)
+  {
+    return pair;
+  }
+
+  pair.count = (size_t)state->count;
+  pair.mean_x = state->mean_x;
+  pair.mean_y = state->mean_y;
+  pair.variance_x = state->m2_x > 0.0 ? state->m2_x / state->count : 0.0;
+  pair.variance_y = state->m2_y > 0.0 ? state->m2_y / state->count : 0.0;
+  pair.covariance = state->c_xy / state->count;
+  if(pair.variance_x > 0.0 && pair.variance_y > 0.0)
+  {
+    pair.correlation = pair.covariance / sqrt(pair.variance_x * pair.variance_y);
+    pair.correlation = pair.correlation > 1.0 ? 1.0 : pair.correlation;
+    pair.correlation = pair.correlation < -1.0 ? -1.0 : pair.correlation;
+  }
+  if(pair.variance_x > 0.0)
+  {
+    pair.slope = pair.covariance / pair.variance_x;
+  }
+  pair.intercept = pair.mean_y - pair.slope * pair.mean_x;
+
+  return pair;
+}
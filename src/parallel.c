@@ -0,0 +1,356 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file parallel.c
+ * @brief File containing the definition of the multithreaded reduction engine.
+ *
+ * Worker t reduces chunks t, t+T, t+2T... of the array, so the work is split evenly without any
+ * synchronization between workers. When the histogram is requested it is the only pass over a chunk
+ * and the minimum, maximum and sum are read from the 256 counters. Otherwise the requested kernels
+ * run back to back on each chunk while it is still in cache. The partial results of the workers are
+ * merged by the calling thread, which also acts as worker 0. Arrays reduced on the calling thread
+ * follow the same rules with chunks taken in order. If a thread cannot be created its chunks are reduced by the calling
+ * thread, so a reduction never fails. The threads are started by parallel_run, which other engines
+ * use for their own parallel passes.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+#if defined (HOST)
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include "parallel.h"
+#include "kernels.h"
+
+#ifdef PARALLEL_THREADS
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+/* State of one worker: its share of the array and its partial results */
+typedef struct
+{
+  const uint8_t * src;
+  size_t length;
+  size_t first_chunk;
+  size_t stride;
+  uint8_t ops;
+  parallel_result_t result;
+  size_t histogram[256];
+} parallel_worker_t;
+
+/* One call of a task, the argument of a thread */
+typedef struct
+{
+  parallel_task_t task;
+  void * arg;
+  size_t index;
+} parallel_job_t;
+
+/* Configured thread count, 0 means one per online CPU */
+static size_t parallel_threads = 0;
+
+/* Arrays smaller than this are reduced on the calling thread */
+static size_t parallel_threshold = PARALLEL_MIN_SIZE_B;
+
+static void reduce_serial(const uint8_t * src, size_t length, uint8_t ops, parallel_result_t * result, size_t * histogram);
+static void reduce_init(parallel_result_t * result);
+static void reduce_chunk(const stats_kernels_t * kernels, const uint8_t * src, size_t size, uint8_t ops,
+                         parallel_result_t * result);
+static void reduce_histogram(const size_t * histogram, uint8_t ops, parallel_result_t * result);
+#ifdef PARALLEL_THREADS
+static void parallel_worker(void * arg, size_t index);
+static void * parallel_thread(void * arg);
+#endif
+
+/* Function definition*/
+void parallel_set_threads(size_t threads)
+{
+  parallel_threads = threads > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : threads;
+}
+
+size_t parallel_get_configured_threads(void)
+{
+  return parallel_threads;
+}
+
+size_t parallel_get_threads(void)
+{
+#ifdef PARALLEL_THREADS
+  long online;
+
+  if(parallel_threads != 0)
+  {
+    return parallel_threads;
+  }
+
+  online = sysconf(_SC_NPROCESSORS_ONLN);
+  if(online < 1)
+  {
+    return 1;
+  }
+  return (size_t)online > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : (size_t)online;
+#else
+  return 1;
+#endif
+}
+
+void parallel_set_threshold(size_t min_size)
+{
+  parallel_threshold = min_size;
+}
+
+size_t parallel_get_threshold(void)
+{
+  return parallel_threshold;
+}
+
+void parallel_reduce(const uint8_t * src, size_t length, uint8_t ops, parallel_result_t * result, size_t * histogram)
+{
+#ifdef PARALLEL_THREADS
+  parallel_worker_t workers[PARALLEL_MAX_THREADS];
+  size_t chunks = (length + PARALLEL_CHUNK_SIZE_B - 1) / PARALLEL_CHUNK_SIZE_B;
+  size_t threads = parallel_get_threads();
+  size_t value;
+  size_t t;
+
+  threads = threads > chunks ? chunks : threads;
+  if(length < parallel_threshold || threads <= 1)
+  {
+    reduce_serial(src, length, ops, result, histogram);
+    return;
+  }
+
+  /* Resolve the kernel dispatch before any worker can race on it */
+  (void)kernels_get();
+
+  for(t = 0; t < threads; ++t)
+  {
+    workers[t].src = src;
+    workers[t].length = length;
+    workers[t].first_chunk = t;
+    workers[t].stride = threads;
+    workers[t].ops = ops;
+  }
+  parallel_run(parallel_worker, workers, threads);
+
+  /* Merge the partial results into worker 0 */
+  for(t = 1; t < threads; ++t)
+  {
+    workers[0].result.minimum = workers[0].result.minimum > workers[t].result.minimum ? workers[t].result.minimum : workers[0].result.minimum;
+    workers[0].result.maximum = workers[0].result.maximum < workers[t].result.maximum ? workers[t].result.maximum : workers[0].result.maximum;
+    workers[0].result.sum += workers[t].result.sum;
+    if(ops & PARALLEL_OP_HISTOGRAM)
+    {
+      for(value = 0; value < 256; ++value)
+      {
+        workers[0].histogram[value] += workers[t].histogram[value];
+      }
+    }
+  }
+
+  if(result != NULL)
+  {
+    *result = workers[0].result;
+  }
+  if(ops & PARALLEL_OP_HISTOGRAM)
+  {
+    for(value = 0; value < 256; ++value)
+    {
+      *(histogram+value) = workers[0].histogram[value];
+    }
+  }
+#else
+  reduce_serial(src, length, ops, result, histogram);
+#endif
+}
+
+void parallel_run(parallel_task_t task, void * arg, size_t count)
+{
+#ifdef PARALLEL_THREADS
+  parallel_job_t jobs[PARALLEL_MAX_THREADS];
+  pthread_t ids[PARALLEL_MAX_THREADS];
+  uint8_t created[PARALLEL_MAX_THREADS];
+  size_t t;
+
+  count = count > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : count;
+  for(t = 0; t < count; ++t)
+  {
+    jobs[t].task = task;
+    jobs[t].arg = arg;
+    jobs[t].index = t;
+    created[t] = 0;
+  }
+  for(t = 1; t < count; ++t)
+  {
+    created[t] = (pthread_create(&ids[t], NULL, parallel_thread, &jobs[t]) == 0) ? 1 : 0;
+  }
+  for(t = 0; t < count; ++t)
+  {
+    if(!created[t])
+    {
+      task(arg, t);
+    }
+  }
+  for(t = 1; t < count; ++t)
+  {
+    if(created[t])
+    {
+      pthread_join(ids[t], NULL);
+    }
+  }
+#else
+  size_t t;
+
+  for(t = 0; t < count; ++t)
+  {
+    task(arg, t);
+  }
+#endif
+}
+
+static void reduce_serial(const uint8_t * src, size_t length, uint8_t ops, parallel_result_t * result, size_t * histogram)
+{
+  const stats_kernels_t * kernels = kernels_get();
+  parallel_result_t serial;
+  size_t offset;
+  size_t size;
+
+  reduce_init(&serial);
+  if(ops & PARALLEL_OP_HISTOGRAM)
+  {
+    /* One counting pass, the other reductions are read from the counters */
+    kernels->histogram(src, length, histogram);
+    reduce_histogram(histogram, ops, &serial);
+  }
+  else
+  {
+    for(offset = 0; offset < length; offset += size)
+    {
+      size = length - offset > PARALLEL_CHUNK_SIZE_B ? PARALLEL_CHUNK_SIZE_B : length - offset;
+      reduce_chunk(kernels, src+offset, size, ops, &serial);
+    }
+  }
+
+  if(result != NULL)
+  {
+    *result = serial;
+  }
+}
+
+static void reduce_init(parallel_result_t * result)
+{
+  result->minimum = 255;
+  result->maximum = 0;
+  result->sum = 0;
+}
+
+static void reduce_chunk(const stats_kernels_t * kernels, const uint8_t * src, size_t size, uint8_t ops,
+                         parallel_result_t * result)
+{
+  uint8_t partial;
+
+  /* Back to back on the same chunk, the later kernels read it from the cache */
+  if(ops & PARALLEL_OP_MINIMUM)
+  {
+    partial = kernels->minimum(src, size);
+    result->minimum = result->minimum > partial ? partial : result->minimum;
+  }
+  if(ops & PARALLEL_OP_MAXIMUM)
+  {
+    partial = kernels->maximum(src, size);
+    result->maximum = result->maximum < partial ? partial : result->maximum;
+  }
+  if(ops & PARALLEL_OP_SUM)
+  {
+    result->sum += kernels->sum(src, size);
+  }
+}
+
+static void reduce_histogram(const size_t * histogram, uint8_t ops, parallel_result_t * result)
+{
+  size_t value;
+
+  for(value = 0; value < 256; ++value)
+  {
+    if(*(histogram+value) != 0)
+    {
+      if(ops & PARALLEL_OP_MINIMUM)
+      {
+        result->minimum = result->minimum > value ? (uint8_t)value : result->minimum;
+      }
+      if(ops & PARALLEL_OP_MAXIMUM)
+      {
+        result->maximum = (uint8_t)value;
+      }
+      if(ops & PARALLEL_OP_SUM)
+      {
+        result->sum += (uint64_t)value * *(histogram+value);
+      }
+    }
+  }
+}
+
+#ifdef PARALLEL_THREADS
+static void * parallel_thread(void * arg)
+{
+  parallel_job_t * job = (parallel_job_t *)arg;
+
+  job->task(job->arg, job->index);
+  return NULL;
+}
+
+static void parallel_worker(void * arg, size_t index)
+{
+  parallel_worker_t * worker = (parallel_worker_t *)arg + index;
+  const stats_kernels_t * kernels = kernels_get();
+  size_t chunk_histogram[256];
+  size_t offset;
+  size_t size;
+  size_t value;
+
+  reduce_init(&worker->result);
+  for(value = 0; value < 256; ++value)
+  {
+    worker->histogram[value] = 0;
+  }
+
+  for(offset = worker->first_chunk * PARALLEL_CHUNK_SIZE_B; offset < worker->length;
+      offset += worker->stride * PARALLEL_CHUNK_SIZE_B)
+  {
+    size = worker->length - offset;
+    size = size > PARALLEL_CHUNK_SIZE_B ? PARALLEL_CHUNK_SIZE_B : size;
+
+    if(worker->ops & PARALLEL_OP_HISTOGRAM)
+    {
+      kernels->histogram(worker->src+offset, size, chunk_histogram);
+      for(value = 0; value < 256; ++value)
+      {
+        worker->histogram[value] += chunk_histogram[value];
+      }
+    }
+    else
+    {
+      reduce_chunk(kernels, worker->src+offset, size, worker->ops, &worker->result);
+    }
+  }
+
+  /* With a histogram the chunks were only counted, the other reductions come from the counters */
+  if(worker->ops & PARALLEL_OP_HISTOGRAM)
+  {
+    reduce_histogram(worker->histogram, worker->ops, &worker->result);
+  }
+}
+#endif
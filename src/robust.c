@@ -0,0 +1,201 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file robust.c
+ * @brief File containing the definition of the robust statistics of an array of unsigned char.
+ *
+ * Every rank is answered by select_kth_histogram, so the cost after the counting pass is a few
+ * walks over 256 bins whatever the size of the array.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "robust.h"
+#include "selection.h"
+
+static stats_robust_t robust_empty(void);
+static stats_robust_t robust_from_counts(const size_t * histogram, double k, size_t * deviations);
+static size_t robust_flag_counts(const unsigned char * array_pointer, size_t array_size, double k,
+                                 uint8_t * bitmap, stats_robust_t * robust, size_t * histogram,
+                                 size_t * deviations, uint8_t * outlier);
+
+/* Function definition*/
+stats_robust_t robust_compute(const unsigned char * array_pointer, size_t array_size, double k)
+{
+  size_t histogram[SELECT_BUCKETS];
+
+  select_histogram(array_pointer, array_size, histogram);
+
+  return robust_from_histogram(histogram, k);
+}
+
+stats_robust_t robust_compute_scratch(const unsigned char * array_pointer, size_t array_size, double k,
+                                      stats_scratch_t * scratch)
+{
+  stats_robust_t robust = robust_empty();
+  size_t mark = scratch_mark(scratch);
+  size_t * histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+  size_t * deviations = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+
+  if(histogram != NULL && deviations != NULL)
+  {
+    select_histogram(array_pointer, array_size, histogram);
+    robust = robust_from_counts(histogram, k, deviations);
+  }
+
+  scratch_release(scratch, mark);
+  return robust;
+}
+
+stats_robust_t robust_from_histogram(const size_t * histogram, double k)
+{
+  size_t deviations[SELECT_BUCKETS];
+
+  return robust_from_counts(histogram, k, deviations);
+}
+
+stats_robust_t robust_from_histogram_scratch(const size_t * histogram, double k, stats_scratch_t * scratch)
+{
+  stats_robust_t robust = robust_empty();
+  size_t mark = scratch_mark(scratch);
+  size_t * deviations = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+
+  if(deviations != NULL)
+  {
+    robust = robust_from_counts(histogram, k, deviations);
+  }
+
+  scratch_release(scratch, mark);
+  return robust;
+}
+
+size_t robust_flag_outliers(const unsigned char * array_pointer, size_t array_size, double k,
+                            uint8_t * bitmap, stats_robust_t * robust)
+{
+  size_t histogram[SELECT_BUCKETS];
+  size_t deviations[SELECT_BUCKETS];
+  uint8_t outlier[SELECT_BUCKETS];
+
+  return robust_flag_counts(array_pointer, array_size, k, bitmap, robust, histogram, deviations, outlier);
+}
+
+size_t robust_flag_outliers_scratch(const unsigned char * array_pointer, size_t array_size, double k,
+                                    uint8_t * bitmap, stats_robust_t * robust, stats_scratch_t * scratch)
+{
+  size_t outliers = 0;
+  size_t mark = scratch_mark(scratch);
+  size_t * histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+  size_t * deviations = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+  uint8_t * outlier = (uint8_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(uint8_t));
+
+  if(histogram != NULL && deviations != NULL && outlier != NULL)
+  {
+    outliers = robust_flag_counts(array_pointer, array_size, k, bitmap, robust, histogram, deviations, outlier);
+  }
+  else if(robust != NULL)
+  {
+    *robust = robust_empty();
+  }
+
+  scratch_release(scratch, mark);
+  return outliers;
+}
+
+static stats_robust_t robust_empty(void)
+{
+  stats_robust_t robust;
+
+  robust.count = 0;
+  robust.median = 0;
+  robust.q1 = 0;
+  robust.q3 = 0;
+  robust.iqr = 0;
+  robust.mad = 0;
+  robust.lower_fence = 0.0;
+  robust.upper_fence = 0.0;
+
+  return robust;
+}
+
+static stats_robust_t robust_from_counts(const size_t * histogram, double k, size_t * deviations)
+{
+  stats_robust_t robust = robust_empty();
+  size_t value;
+
+  for(value = 0; value < SELECT_BUCKETS; ++value)
+  {
+    robust.count += *(histogram+value);
+    *(deviations+value) = 0;
+  }
+
+  if(0 == robust.count)
+  {
+    return robust;
+  }
+
+  robust.median = select_median_histogram(histogram, robust.count);
+  robust.q1 = select_kth_histogram(histogram, select_quantile_rank(0.25, robust.count));
+  robust.q3 = select_kth_histogram(histogram, select_quantile_rank(0.75, robust.count));
+  robust.iqr = robust.q3 - robust.q1;
+  robust.lower_fence = (double)robust.q1 - k * (double)robust.iqr;
+  robust.upper_fence = (double)robust.q3 + k * (double)robust.iqr;
+
+  /* Every sample of a bin has the same absolute deviation from the median */
+  for(value = 0; value < SELECT_BUCKETS; ++value)
+  {
+    *(deviations + (value < robust.median ? robust.median - value : value - robust.median)) += *(histogram+value);
+  }
+  robust.mad = select_median_histogram(deviations, robust.count);
+
+  return robust;
+}
+
+static size_t robust_flag_counts(const unsigned char * array_pointer, size_t array_size, double k,
+                                 uint8_t * bitmap, stats_robust_t * robust, size_t * histogram,
+                                 size_t * deviations, uint8_t * outlier)
+{
+  stats_robust_t fences;
+  size_t outliers = 0;
+  size_t value;
+  size_t i;
+  size_t bit;
+  uint8_t byte;
+
+  select_histogram(array_pointer, array_size, histogram);
+  fences = robust_from_counts(histogram, k, deviations);
+  if(robust != NULL)
+  {
+    *robust = fences;
+  }
+
+  /* The outliers are counted from the histogram, the second pass only writes the bitmap */
+  for(value = 0; value < SELECT_BUCKETS; ++value)
+  {
+    *(outlier+value) = ((double)value < fences.lower_fence || (double)value > fences.upper_fence) ? 1 : 0;
+    outliers += *(outlier+value) ? *(histogram+value) : 0;
+  }
+
+  for(i = 0; i < array_size; i += 8)
+  {
+    byte = 0;
+    for(bit = 0; bit < 8 && i + bit < array_size; ++bit)
+    {
+      byte |= (uint8_t)(*(outlier + *(array_pointer+i+bit)) << bit);
+    }
+    *(bitmap+i/8) = byte;
+  }
+
+  return outliers;
+}
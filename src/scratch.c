@@ -0,0 +1,58 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file scratch.c
+ * @brief File containing the definition of the scratch arena.
+ *
+ * The arena is a bump allocator: a block is the next aligned bytes of the buffer and releasing
+ * only moves the end back, so both are O(1) and there is no per-block header.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "scratch.h"
+
+/* Function definition*/
+void scratch_init(stats_scratch_t * scratch, void * buffer, size_t size)
+{
+  scratch->base = (unsigned char *)buffer;
+  scratch->size = buffer != NULL ? size : 0;
+  scratch->used = 0;
+}
+
+void * scratch_alloc(stats_scratch_t * scratch, size_t bytes)
+{
+  size_t padding;
+
+  /* The buffer itself may not be aligned, so the padding depends on the address */
+  padding = (SCRATCH_ALIGN - (uintptr_t)(scratch->base + scratch->used) % SCRATCH_ALIGN) % SCRATCH_ALIGN;
+  if(scratch->size - scratch->used < padding || scratch->size - scratch->used - padding < bytes)
+  {
+    return NULL;
+  }
+
+  scratch->used += padding + bytes;
+  return scratch->base + scratch->used - bytes;
+}
+
+size_t scratch_mark(const stats_scratch_t * scratch)
+{
+  return scratch->used;
+}
+
+void scratch_release(stats_scratch_t * scratch, size_t mark)
+{
+  scratch->used = mark < scratch->used ? mark : scratch->used;
+}
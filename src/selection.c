@@ -0,0 +1,263 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file selection.c
+ * @brief File containing the definition of the order statistic selection engine.
+ *
+ * Contains the implementation of a counting selection over a 256-bucket histogram and of an
+ * in-place introselect. The introselect partitions around median-of-three pivots while its depth
+ * budget lasts and falls back to median-of-medians pivots afterwards, so the worst case stays
+ * linear. The partition is three-way, which keeps byte data with many repeated values fast.
+ *
+ * The histogram median is generated from one template for the size_t counters of the byte
+ * histograms and for the 64-bit counters of the accumulators.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "selection.h"
+#include "parallel.h"
+
+static uint8_t select_recursive(uint8_t * src, size_t length, size_t k, size_t depth);
+static uint8_t median_of_medians(uint8_t * src, size_t length);
+static uint8_t median_of_three(uint8_t a, uint8_t b, uint8_t c);
+static void partition_three_way(uint8_t * src, size_t length, uint8_t pivot, size_t * lower, size_t * upper);
+static void insertion_sort(uint8_t * src, size_t length);
+
+/* Defines the histogram median select_median_from<suffix> over counters of counter_type */
+#define SELECT_MEDIAN_DEFINE(suffix, counter_type)                                              \
+uint8_t select_median_from##suffix(const counter_type * histogram, counter_type count,          \
+                                   size_t value, counter_type below)                            \
+{                                                                                               \
+  size_t lower;                                                                                 \
+                                                                                                \
+  if(histogram == NULL || 0 == count)                                                           \
+  {                                                                                             \
+    return 0;                                                                                   \
+  }                                                                                             \
+                                                                                                \
+  /* Both middle ranks are the same for odd counts */                                           \
+  while(value < SELECT_BUCKETS - 1 && below + *(histogram+value) <= (count - 1) / 2)            \
+  {                                                                                             \
+    below += *(histogram+value);                                                                \
+    ++value;                                                                                    \
+  }                                                                                             \
+  lower = value;                                                                                \
+  while(value < SELECT_BUCKETS - 1 && below + *(histogram+value) <= count / 2)                  \
+  {                                                                                             \
+    below += *(histogram+value);                                                                \
+    ++value;                                                                                    \
+  }                                                                                             \
+                                                                                                \
+  return (uint8_t)((lower + value) / 2);                                                        \
+}
+
+/* Function definition*/
+SELECT_MEDIAN_DEFINE(, size_t)
+SELECT_MEDIAN_DEFINE(_u64, uint64_t)
+
+void select_histogram(const uint8_t * src, size_t length, size_t * histogram)
+{
+  parallel_reduce(src, length, PARALLEL_OP_HISTOGRAM, NULL, histogram);
+}
+
+uint8_t select_kth_counting(const uint8_t * src, size_t length, size_t k)
+{
+  size_t histogram[SELECT_BUCKETS];
+
+  if(k >= length)
+  {
+    return 0;
+  }
+
+  select_histogram(src, length, histogram);
+
+  return select_kth_histogram(histogram, k);
+}
+
+uint8_t select_kth_histogram(const size_t * histogram, size_t k)
+{
+  size_t value;
+  size_t seen = 0;
+
+  for(value = 0; value < SELECT_BUCKETS; ++value)
+  {
+    seen += *(histogram+value);
+    if(seen > k)
+    {
+      return (uint8_t)value;
+    }
+  }
+
+  return 0;
+}
+
+uint8_t select_median_histogram(const size_t * histogram, size_t count)
+{
+  return select_median_from(histogram, count, 0, 0);
+}
+
+size_t select_quantile_rank(double q, size_t count)
+{
+  if(0 == count)
+  {
+    return 0;
+  }
+  q = q > 0.0 ? q : 0.0;
+  q = q < 1.0 ? q : 1.0;
+
+  return (size_t)(q * (double)(count - 1) + 0.5);
+}
+
+uint8_t select_kth_inplace(uint8_t * src, size_t length, size_t k)
+{
+  size_t depth = 0;
+  size_t n;
+
+  if(src == NULL || k >= length)
+  {
+    return 0;
+  }
+
+  /* Allow 2*log2(n) quickselect rounds before switching to median-of-medians */
+  for(n = length; n > 1; n >>= 1)
+  {
+    depth += 2;
+  }
+
+  return select_recursive(src, length, k, depth);
+}
+
+static uint8_t select_recursive(uint8_t * src, size_t length, size_t k, size_t depth)
+{
+  uint8_t pivot;
+  size_t lower;
+  size_t upper;
+
+  while(length > SELECT_INSERTION_CUTOFF)
+  {
+    if(depth == 0)
+    {
+      pivot = median_of_medians(src, length);
+    }
+    else
+    {
+      --depth;
+      pivot = median_of_three(*src, *(src+length/2), *(src+length-1));
+    }
+
+    partition_three_way(src, length, pivot, &lower, &upper);
+
+    if(k < lower)
+    {
+      length = lower;
+    }
+    else if(k < upper)
+    {
+      return pivot;
+    }
+    else
+    {
+      src += upper;
+      length -= upper;
+      k -= upper;
+    }
+  }
+
+  insertion_sort(src, length);
+
+  return *(src+k);
+}
+
+static uint8_t median_of_medians(uint8_t * src, size_t length)
+{
+  size_t i;
+  size_t group;
+  size_t medians = 0;
+  uint8_t tmp;
+
+  /* Move the median of every group of five to the front of the array */
+  for(i = 0; i < length; i += 5)
+  {
+    group = (length - i) < 5 ? (length - i) : 5;
+    insertion_sort(src+i, group);
+    tmp = *(src+medians);
+    *(src+medians) = *(src+i+group/2);
+    *(src+i+group/2) = tmp;
+    ++medians;
+  }
+
+  return select_recursive(src, medians, medians/2, 0);
+}
+
+static uint8_t median_of_three(uint8_t a, uint8_t b, uint8_t c)
+{
+  if(a < b)
+  {
+    return b < c ? b : (a < c ? c : a);
+  }
+  return a < c ? a : (b < c ? c : b);
+}
+
+static void partition_three_way(uint8_t * src, size_t length, uint8_t pivot, size_t * lower, size_t * upper)
+{
+  size_t lt = 0;
+  size_t i = 0;
+  size_t gt = length;
+  uint8_t tmp;
+
+  /* Dutch national flag: [0,lt) < pivot, [lt,i) == pivot, [gt,length) > pivot */
+  while(i < gt)
+  {
+    tmp = *(src+i);
+    if(tmp < pivot)
+    {
+      *(src+i) = *(src+lt);
+      *(src+lt) = tmp;
+      ++lt;
+      ++i;
+    }
+    else if(tmp > pivot)
+    {
+      --gt;
+      *(src+i) = *(src+gt);
+      *(src+gt) = tmp;
+    }
+    else
+    {
+      ++i;
+    }
+  }
+
+  *lower = lt;
+  *upper = gt;
+}
+
+static void insertion_sort(uint8_t * src, size_t length)
+{
+  size_t i;
+  size_t j;
+  uint8_t current_value;
+
+  for(i = 1; i < length; ++i)
+  {
+    current_value = *(src+i);
+    for(j = i; j > 0 && *(src+j-1) > current_value; --j)
+    {
+      *(src+j) = *(src+j-1);
+    }
+    *(src+j) = current_value;
+  }
+}
@@ -0,0 +1,339 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file sketch.c
+ * @brief File containing the definition of the streaming quantile sketch.
+ *
+ * The level of depth d below the top has a capacity of K*(2/3)^d, at least SKETCH_MIN_WIDTH. When
+ * the levels hold as many samples as their capacities add up to, the lowest level at capacity is
+ * compacted: it is sorted, one sample is kept back if its size is odd, and half of the others are
+ * promoted to the level above. Compacting the top level opens a new level. Every compaction keeps
+ * the total weight equal to the count, so only the ranks are approximate. Queries walk the sorted
+ * levels together, like a multiway merge, adding 2^h for every sample of level h.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "sketch.h"
+#include "sort.h"
+
+static size_t level_capacity(size_t level, size_t levels);
+static void sketch_add_level(stats_sketch_t * sketch);
+static void sketch_compress(stats_sketch_t * sketch);
+static void sketch_insert_level(stats_sketch_t * sketch, size_t level, double sample);
+static void sketch_sort_levels(stats_sketch_t * sketch);
+static int compare_double(const void * a, const void * b);
+
+/* Function definition*/
+void sketch_init(stats_sketch_t * sketch)
+{
+  size_t level;
+
+  sketch->count = 0;
+  sketch->minimum = 0.0;
+  sketch->maximum = 0.0;
+  sketch->random = 0x9E3779B9u;
+  sketch->sorted = 1;
+  sketch->levels = 1;
+  sketch->capacity = level_capacity(0, 1);
+  sketch->stored = 0;
+  for(level = 0; level < SKETCH_MAX_LEVELS; ++level)
+  {
+    sketch->level_size[level] = 0;
+  }
+}
+
+void sketch_insert(stats_sketch_t * sketch, double sample)
+{
+  if(sample != sample)
+  {
+    return;
+  }
+
+  if(sketch->count == 0)
+  {
+    sketch->minimum = sample;
+    sketch->maximum = sample;
+  }
+  sketch->minimum = sample < sketch->minimum ? sample : sketch->minimum;
+  sketch->maximum = sample > sketch->maximum ? sample : sketch->maximum;
+  ++sketch->count;
+
+  sketch_insert_level(sketch, 0, sample);
+}
+
+void sketch_insert_array(stats_sketch_t * sketch, const double * array_pointer, size_t array_size)
+{
+  size_t i;
+
+  for(i = 0; i < array_size; ++i)
+  {
+    sketch_insert(sketch, *(array_pointer+i));
+  }
+}
+
+void sketch_merge(stats_sketch_t * dst, const stats_sketch_t * src)
+{
+  size_t offset = 0;
+  size_t level;
+  size_t i;
+
+  if(src->count == 0)
+  {
+    return;
+  }
+
+  if(dst->count == 0)
+  {
+    dst->minimum = src->minimum;
+    dst->maximum = src->maximum;
+  }
+  dst->minimum = src->minimum < dst->minimum ? src->minimum : dst->minimum;
+  dst->maximum = src->maximum > dst->maximum ? src->maximum : dst->maximum;
+  dst->count += src->count;
+
+  /* Every sample keeps its weight by going to the same level of dst */
+  for(level = src->levels; level > 0; --level)
+  {
+    for(i = 0; i < src->level_size[level - 1]; ++i)
+    {
+      sketch_insert_level(dst, level - 1, src->items[offset + i]);
+    }
+    offset += src->level_size[level - 1];
+  }
+}
+
+double sketch_quantile(stats_sketch_t * sketch, double q)
+{
+  size_t cursor[SKETCH_MAX_LEVELS];
+  size_t limit[SKETCH_MAX_LEVELS];
+  size_t offset = 0;
+  size_t level;
+  size_t best;
+  uint64_t weight = 0;
+  double target;
+
+  if(sketch->count == 0)
+  {
+    return 0.0;
+  }
+  if(q <= 0.0)
+  {
+    return sketch->minimum;
+  }
+  if(q >= 1.0)
+  {
+    return sketch->maximum;
+  }
+
+  sketch_sort_levels(sketch);
+  for(level = sketch->levels; level > 0; --level)
+  {
+    cursor[level - 1] = offset;
+    offset += sketch->level_size[level - 1];
+    limit[level - 1] = offset;
+  }
+
+  target = q * (double)sketch->count;
+  for(;;)
+  {
+    best = sketch->levels;
+    for(level = 0; level < sketch->levels; ++level)
+    {
+      if(cursor[level] < limit[level] &&
+         (best == sketch->levels || sketch->items[cursor[level]] < sketch->items[cursor[best]]))
+      {
+        best = level;
+      }
+    }
+    if(best == sketch->levels)
+    {
+      break;
+    }
+
+    weight += (uint64_t)1 << best;
+    if((double)weight >= target)
+    {
+      return sketch->items[cursor[best]];
+    }
+    ++cursor[best];
+  }
+
+  return sketch->maximum;
+}
+
+double sketch_cdf(const stats_sketch_t * sketch, double x)
+{
+  size_t offset = 0;
+  size_t level;
+  size_t i;
+  uint64_t weight = 0;
+
+  if(sketch->count == 0)
+  {
+    return 0.0;
+  }
+
+  for(level = sketch->levels; level > 0; --level)
+  {
+    for(i = 0; i < sketch->level_size[level - 1]; ++i)
+    {
+      if(sketch->items[offset + i] <= x)
+      {
+        weight += (uint64_t)1 << (level - 1);
+      }
+    }
+    offset += sketch->level_size[level - 1];
+  }
+
+  return (double)weight / (double)sketch->count;
+}
+
+static size_t level_capacity(size_t level, size_t levels)
+{
+  size_t capacity = SKETCH_K;
+  size_t depth;
+
+  for(depth = levels - 1 - level; depth > 0 && capacity > SKETCH_MIN_WIDTH; --depth)
+  {
+    capacity = capacity * 2 / 3;
+  }
+
+  return capacity < SKETCH_MIN_WIDTH ? SKETCH_MIN_WIDTH : capacity;
+}
+
+static void sketch_add_level(stats_sketch_t * sketch)
+{
+  size_t level;
+
+  /* The new top level is empty and goes in front of the others, so no sample moves */
+  sketch->level_size[sketch->levels] = 0;
+  ++sketch->levels;
+
+  sketch->capacity = 0;
+  for(level = 0; level < sketch->levels; ++level)
+  {
+    sketch->capacity += level_capacity(level, sketch->levels);
+  }
+}
+
+static void sketch_compress(stats_sketch_t * sketch)
+{
+  size_t level;
+  size_t start;
+  size_t end = sketch->stored;
+  size_t size;
+  size_t odd;
+  size_t half;
+  size_t offset;
+  size_t i;
+  double kept;
+
+  /* The levels hold at least their total capacity, so one of them is at capacity */
+  for(level = 0; level < sketch->levels; ++level)
+  {
+    if(sketch->level_size[level] >= level_capacity(level, sketch->levels))
+    {
+      break;
+    }
+    end -= sketch->level_size[level];
+  }
+  if(level + 1 == sketch->levels)
+  {
+    sketch_add_level(sketch);
+  }
+
+  size = sketch->level_size[level];
+  start = end - size;
+  odd = size & 1;
+  half = (size - odd) / 2;
+  kept = sketch->items[start];
+  sort_generic(&sketch->items[start + odd], size - odd, sizeof(double), compare_double);
+
+  sketch->random ^= sketch->random << 13;
+  sketch->random ^= sketch->random >> 17;
+  sketch->random ^= sketch->random << 5;
+  offset = start + odd + (sketch->random & 1);
+
+  /* The promoted samples extend the level above, which ends where this one starts */
+  for(i = 0; i < half; ++i)
+  {
+    sketch->items[start + i] = sketch->items[offset + 2 * i];
+  }
+  if(odd)
+  {
+    sketch->items[start + half] = kept;
+  }
+  memmove(&sketch->items[start + half + odd], &sketch->items[end], (sketch->stored - end) * sizeof(double));
+
+  sketch->level_size[level + 1] += half;
+  sketch->level_size[level] = odd;
+  sketch->stored -= half;
+}
+
+static void sketch_insert_level(stats_sketch_t * sketch, size_t level, double sample)
+{
+  size_t end;
+  size_t lower;
+
+  while(level >= sketch->levels)
+  {
+    sketch_add_level(sketch);
+  }
+  while(sketch->stored >= sketch->capacity)
+  {
+    sketch_compress(sketch);
+  }
+
+  /* The levels below are stored after this one and move up by one sample */
+  end = sketch->stored;
+  for(lower = 0; lower < level; ++lower)
+  {
+    end -= sketch->level_size[lower];
+  }
+  memmove(&sketch->items[end + 1], &sketch->items[end], (sketch->stored - end) * sizeof(double));
+
+  sketch->items[end] = sample;
+  ++sketch->level_size[level];
+  ++sketch->stored;
+  sketch->sorted = 0;
+}
+
+static void sketch_sort_levels(stats_sketch_t * sketch)
+{
+  size_t offset = 0;
+  size_t level;
+
+  if(sketch->sorted)
+  {
+    return;
+  }
+
+  for(level = sketch->levels; level > 0; --level)
+  {
+    sort_generic(&sketch->items[offset], sketch->level_size[level - 1], sizeof(double), compare_double);
+    offset += sketch->level_size[level - 1];
+  }
+  sketch->sorted = 1;
+}
+
+static int compare_double(const void * a, const void * b)
+{
+  double x = *(const double *)a;
+  double y = *(const double *)b;
+
+  return (x > y) - (x < y);
+}
@@ -0,0 +1,682 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file sort.c
+ * @brief File containing the definition of the sort engine.
+ *
+ * The counting sort reuses the histogram engine of the statistics functions, so it runs on the
+ * fastest kernels and threads available. The radix sorts count every byte position in a single pass
+ * over the keys and then scatter once per byte, back and forth between the array and the scratch
+ * array. The introsort loops on the larger partition and recurses on the smaller one, so its stack
+ * depth is O(log n) even on the MSP432.
+ *
+ * The parallel variants split the output into one slice per thread with slice_bound, so a thread
+ * never writes outside its slice and no locking is needed.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "sort.h"
+#include "selection.h"
+#include "parallel.h"
+
+/* Number of buckets of one radix pass, one per byte value */
+#define SORT_RADIX_BUCKETS (256)
+
+/* Pointer to the element at an index of a generic array */
+#define SORT_ELEMENT(base, index, size) ((unsigned char *)(base) + (index) * (size))
+
+/* Shared state of the threads of sort_counting_u8_parallel */
+typedef struct
+{
+  uint8_t * dst;
+  size_t length;
+  size_t tasks;
+  const size_t * histogram;
+  sort_order_t order;
+} sort_fill_t;
+
+/* Shared state of the threads of sort_generic_parallel */
+typedef struct
+{
+  unsigned char * src;
+  unsigned char * dst;
+  size_t count;
+  size_t size;
+  int (*compare)(const void *, const void *);
+  size_t tasks;
+  size_t runs;
+  const size_t * bounds;
+} sort_merge_t;
+
+static size_t slice_bound(size_t length, size_t slices, size_t index);
+static void fill_from_histogram(uint8_t * dst, const size_t * histogram, sort_order_t order,
+                                size_t first, size_t last);
+static void fill_task(void * arg, size_t index);
+static void run_sort_task(void * arg, size_t index);
+static void merge_task(void * arg, size_t index);
+static size_t merge_path(const unsigned char * a, size_t a_count, const unsigned char * b, size_t b_count,
+                         size_t diagonal, size_t size, int (*compare)(const void *, const void *));
+static void introsort_loop(unsigned char * base, size_t count, size_t size,
+                           int (*compare)(const void *, const void *), size_t depth);
+static void select_loop(unsigned char * base, size_t count, size_t size,
+                        int (*compare)(const void *, const void *), size_t depth,
+                        size_t first, const size_t * ranks, size_t rank_count);
+static size_t partition(unsigned char * base, size_t count, size_t size,
+                        int (*compare)(const void *, const void *));
+static void insertion_sort(unsigned char * base, size_t count, size_t size,
+                           int (*compare)(const void *, const void *));
+static void heap_sort(unsigned char * base, size_t count, size_t size,
+                      int (*compare)(const void *, const void *));
+static void sift_down(unsigned char * base, size_t root, size_t count, size_t size,
+                      int (*compare)(const void *, const void *));
+static void swap_elements(unsigned char * a, unsigned char * b, size_t size);
+
+/*
+ * Defines an LSD radix sort over the bytes of an unsigned integer type. The histograms of every
+ * byte position are built in one pass, and a pass is skipped when all keys share that byte.
+ */
+#define SORT_RADIX_DEFINE(name, type)                                                          \
+void name(type * src, size_t length, type * scratch, sort_order_t order)                       \
+{                                                                                              \
+  size_t counts[sizeof(type)][SORT_RADIX_BUCKETS];                                             \
+  size_t offset;                                                                               \
+  size_t bucket;                                                                               \
+  size_t pass;                                                                                 \
+  size_t i;                                                                                    \
+  type * from = src;                                                                           \
+  type * to = scratch;                                                                         \
+  type * swap;                                                                                 \
+                                                                                               \
+  if(src == NULL || scratch == NULL || length < 2)                                             \
+  {                                                                                            \
+    return;                                                                                    \
+  }                                                                                            \
+                                                                                               \
+  memset(counts, 0, sizeof(counts));                                                           \
+  for(i = 0; i < length; ++i)                                                                  \
+  {                                                                                            \
+    for(pass = 0; pass < sizeof(type); ++pass)                                                 \
+    {                                                                                          \
+      ++counts[pass][(*(src+i) >> (8 * pass)) & 0xFF];                                         \
+    }                                                                                          \
+  }                                                                                            \
+                                                                                               \
+  for(pass = 0; pass < sizeof(type); ++pass)                                                   \
+  {                                                                                            \
+    if(counts[pass][(*from >> (8 * pass)) & 0xFF] == length)                                   \
+    {                                                                                          \
+      continue;                                                                                \
+    }                                                                                          \
+                                                                                               \
+    /* Turn the counts into the first output index of every bucket */                          \
+    offset = 0;                                                                                \
+    for(i = 0; i < SORT_RADIX_BUCKETS; ++i)                                                    \
+    {                                                                                          \
+      bucket = (order == SORT_DESCENDING) ? SORT_RADIX_BUCKETS - 1 - i : i;                    \
+      offset += counts[pass][bucket];                                                          \
+      counts[pass][bucket] = offset - counts[pass][bucket];                                    \
+    }                                                                                          \
+                                                                                               \
+    for(i = 0; i < length; ++i)                                                                \
+    {                                                                                          \
+      bucket = (*(from+i) >> (8 * pass)) & 0xFF;                                               \
+      *(to+counts[pass][bucket]++) = *(from+i);                                                \
+    }                                                                                          \
+                                                                                               \
+    swap = from;                                                                               \
+    from = to;                                                                                 \
+    to = swap;                                                                                 \
+  }                                                                                            \
+                                                                                               \
+  if(from != src)                                                                              \
+  {                                                                                            \
+    memcpy(src, from, length * sizeof(type));                                                  \
+  }                                                                                            \
+}
+
+SORT_RADIX_DEFINE(sort_radix_u16, uint16_t)
+SORT_RADIX_DEFINE(sort_radix_u32, uint32_t)
+
+/* Function definition*/
+void sort_counting_u8(uint8_t * src, size_t length, sort_order_t order)
+{
+  size_t histogram[SELECT_BUCKETS];
+
+  if(src == NULL || length < 2)
+  {
+    return;
+  }
+
+  select_histogram(src, length, histogram);
+  fill_from_histogram(src, histogram, order, 0, length);
+}
+
+void sort_counting_u8_parallel(uint8_t * src, size_t length, sort_order_t order)
+{
+  size_t histogram[SELECT_BUCKETS];
+  size_t tasks = parallel_get_threads();
+  sort_fill_t fill;
+
+  if(src == NULL || length < 2)
+  {
+    return;
+  }
+
+  select_histogram(src, length, histogram);
+
+  if(length < parallel_get_threshold() || tasks <= 1)
+  {
+    fill_from_histogram(src, histogram, order, 0, length);
+    return;
+  }
+
+  fill.dst = src;
+  fill.length = length;
+  fill.tasks = tasks;
+  fill.histogram = histogram;
+  fill.order = order;
+  parallel_run(fill_task, &fill, tasks);
+}
+
+void sort_radix_i32(int32_t * src, size_t length, int32_t * scratch, sort_order_t order)
+{
+  uint32_t * keys = (uint32_t *)src;
+  size_t i;
+
+  if(src == NULL || scratch == NULL || length < 2)
+  {
+    return;
+  }
+
+  for(i = 0; i < length; ++i)
+  {
+    *(keys+i) ^= 0x80000000u;
+  }
+  sort_radix_u32(keys, length, (uint32_t *)scratch, order);
+  for(i = 0; i < length; ++i)
+  {
+    *(keys+i) ^= 0x80000000u;
+  }
+}
+
+void sort_generic(void * base, size_t count, size_t size, int (*compare)(const void *, const void *))
+{
+  size_t depth = 0;
+  size_t n;
+
+  if(base == NULL || compare == NULL || size == 0 || count < 2)
+  {
+    return;
+  }
+
+  for(n = count; n > 1; n >>= 1)
+  {
+    depth += 2;
+  }
+
+  introsort_loop((unsigned char *)base, count, size, compare, depth);
+}
+
+void sort_select(void * base, size_t count, size_t size, int (*compare)(const void *, const void *),
+                 const size_t * ranks, size_t rank_count)
+{
+  size_t depth = 0;
+  size_t n;
+
+  if(base == NULL || compare == NULL || size == 0 || count < 2)
+  {
+    return;
+  }
+
+  /* Ranks out of range are ignored, they are the last ones since the ranks are sorted */
+  while(rank_count > 0 && *(ranks+rank_count-1) >= count)
+  {
+    --rank_count;
+  }
+
+  for(n = count; n > 1; n >>= 1)
+  {
+    depth += 2;
+  }
+
+  select_loop((unsigned char *)base, count, size, compare, depth, 0, ranks, rank_count);
+}
+
+void sort_partial(void * base, size_t count, size_t size, int (*compare)(const void *, const void *), size_t k)
+{
+  unsigned char * elements = (unsigned char *)base;
+  size_t rank;
+  size_t i;
+
+  if(base == NULL || compare == NULL || size == 0 || k == 0 || count < 2)
+  {
+    return;
+  }
+  if(k >= count)
+  {
+    sort_generic(base, count, size, compare);
+    return;
+  }
+
+  if(k <= SORT_PARTIAL_HEAP_MAX)
+  {
+    /* The root of the heap is the largest of the k smallest elements seen so far */
+    for(i = k / 2; i > 0; --i)
+    {
+      sift_down(elements, i - 1, k, size, compare);
+    }
+    for(i = k; i < count; ++i)
+    {
+      if(compare(SORT_ELEMENT(elements, i, size), elements) < 0)
+      {
+        swap_elements(elements, SORT_ELEMENT(elements, i, size), size);
+        sift_down(elements, 0, k, size, compare);
+      }
+    }
+    heap_sort(elements, k, size, compare);
+  }
+  else
+  {
+    /* The k-th element is in place once selected, only the elements before it are left to sort */
+    rank = k - 1;
+    sort_select(base, count, size, compare, &rank, 1);
+    sort_generic(base, k - 1, size, compare);
+  }
+}
+
+void sort_generic_parallel(void * base, size_t count, size_t size, int (*compare)(const void *, const void *),
+                           void * scratch)
+{
+  size_t bounds[PARALLEL_MAX_THREADS + 1];
+  size_t tasks = parallel_get_threads();
+  size_t run;
+  unsigned char * swap;
+  sort_merge_t merge;
+
+  if(base == NULL || compare == NULL || size == 0 || count < 2)
+  {
+    return;
+  }
+
+  tasks = tasks > count / SORT_PARALLEL_MIN_RUN ? count / SORT_PARALLEL_MIN_RUN : tasks;
+  tasks = tasks > PARALLEL_MAX_THREADS ? PARALLEL_MAX_THREADS : tasks;
+  if(scratch == NULL || tasks <= 1 || count * size < parallel_get_threshold())
+  {
+    sort_generic(base, count, size, compare);
+    return;
+  }
+
+  for(run = 0; run <= tasks; ++run)
+  {
+    bounds[run] = slice_bound(count, tasks, run);
+  }
+
+  merge.src = (unsigned char *)base;
+  merge.dst = (unsigned char *)scratch;
+  merge.count = count;
+  merge.size = size;
+  merge.compare = compare;
+  merge.tasks = tasks;
+  merge.runs = tasks;
+  merge.bounds = bounds;
+  parallel_run(run_sort_task, &merge, tasks);
+
+  while(merge.runs > 1)
+  {
+    parallel_run(merge_task, &merge, tasks);
+
+    /* Run k of the next round is the merge of runs 2k and 2k+1 */
+    merge.runs = (merge.runs + 1) / 2;
+    for(run = 0; run < merge.runs; ++run)
+    {
+      bounds[run] = bounds[2 * run];
+    }
+    bounds[merge.runs] = count;
+
+    swap = merge.src;
+    merge.src = merge.dst;
+    merge.dst = swap;
+  }
+
+  if(merge.src != (unsigned char *)base)
+  {
+    memcpy(base, merge.src, count * size);
+  }
+}
+
+static size_t slice_bound(size_t length, size_t slices, size_t index)
+{
+  size_t extra = length % slices;
+
+  return (length / slices) * index + (index < extra ? index : extra);
+}
+
+static void fill_from_histogram(uint8_t * dst, const size_t * histogram, sort_order_t order,
+                                size_t first, size_t last)
+{
+  size_t offset = 0;
+  size_t lower;
+  size_t upper;
+  size_t value;
+  size_t i;
+
+  for(i = 0; i < SELECT_BUCKETS && offset < last; ++i)
+  {
+    value = (order == SORT_DESCENDING) ? SELECT_BUCKETS - 1 - i : i;
+    lower = offset > first ? offset : first;
+    offset += *(histogram+value);
+    upper = offset < last ? offset : last;
+    if(lower < upper)
+    {
+      memset(dst+lower, (int)value, upper - lower);
+    }
+  }
+}
+
+static void fill_task(void * arg, size_t index)
+{
+  sort_fill_t * fill = (sort_fill_t *)arg;
+
+  fill_from_histogram(fill->dst, fill->histogram, fill->order,
+                      slice_bound(fill->length, fill->tasks, index),
+                      slice_bound(fill->length, fill->tasks, index + 1));
+}
+
+static void run_sort_task(void * arg, size_t index)
+{
+  sort_merge_t * merge = (sort_merge_t *)arg;
+  size_t first = *(merge->bounds+index);
+
+  sort_generic(SORT_ELEMENT(merge->src, first, merge->size), *(merge->bounds+index+1) - first,
+               merge->size, merge->compare);
+}
+
+static void merge_task(void * arg, size_t index)
+{
+  sort_merge_t * merge = (sort_merge_t *)arg;
+  size_t size = merge->size;
+  size_t first = slice_bound(merge->count, merge->tasks, index);
+  size_t last = slice_bound(merge->count, merge->tasks, index + 1);
+  size_t start;
+  size_t middle;
+  size_t end;
+  size_t diagonal;
+  size_t stop;
+  size_t i;
+  size_t j;
+  size_t pair;
+  const unsigned char * a;
+  const unsigned char * b;
+  unsigned char * out;
+
+  for(pair = 0; 2 * pair < merge->runs; ++pair)
+  {
+    start = *(merge->bounds+2*pair);
+    middle = *(merge->bounds+2*pair+1);
+    end = (2 * pair + 2 <= merge->runs) ? *(merge->bounds+2*pair+2) : merge->count;
+    if(end <= first)
+    {
+      continue;
+    }
+    if(start >= last)
+    {
+      break;
+    }
+
+    /* Write the part of this merge that falls in the slice [first, last) of the output */
+    a = SORT_ELEMENT(merge->src, start, size);
+    b = SORT_ELEMENT(merge->src, middle, size);
+    diagonal = (first > start ? first : start) - start;
+    stop = (last < end ? last : end) - start;
+    i = merge_path(a, middle - start, b, end - middle, diagonal, size, merge->compare);
+    j = diagonal - i;
+    out = SORT_ELEMENT(merge->dst, start + diagonal, size);
+    for(; diagonal < stop; ++diagonal)
+    {
+      if(j >= end - middle || (i < middle - start &&
+         merge->compare(SORT_ELEMENT(a, i, size), SORT_ELEMENT(b, j, size)) <= 0))
+      {
+        memcpy(out, SORT_ELEMENT(a, i, size), size);
+        ++i;
+      }
+      else
+      {
+        memcpy(out, SORT_ELEMENT(b, j, size), size);
+        ++j;
+      }
+      out += size;
+    }
+  }
+}
+
+static size_t merge_path(const unsigned char * a, size_t a_count, const unsigned char * b, size_t b_count,
+                         size_t diagonal, size_t size, int (*compare)(const void *, const void *))
+{
+  size_t lower = diagonal > b_count ? diagonal - b_count : 0;
+  size_t upper = diagonal < a_count ? diagonal : a_count;
+  size_t middle;
+
+  /* Number of elements of a among the first diagonal elements of the merge */
+  while(lower < upper)
+  {
+    middle = lower + (upper - lower) / 2;
+    if(compare(SORT_ELEMENT(a, middle, size), SORT_ELEMENT(b, diagonal - middle - 1, size)) <= 0)
+    {
+      lower = middle + 1;
+    }
+    else
+    {
+      upper = middle;
+    }
+  }
+
+  return lower;
+}
+
+static void introsort_loop(unsigned char * base, size_t count, size_t size,
+                           int (*compare)(const void *, const void *), size_t depth)
+{
+  size_t pivot;
+
+  while(count > SORT_INSERTION_CUTOFF)
+  {
+    if(depth == 0)
+    {
+      heap_sort(base, count, size, compare);
+      return;
+    }
+    --depth;
+
+    /* Recurse on the smaller side and loop on the larger one */
+    pivot = partition(base, count, size, compare);
+    if(pivot < count - 1 - pivot)
+    {
+      introsort_loop(base, pivot, size, compare, depth);
+      base = SORT_ELEMENT(base, pivot + 1, size);
+      count = count - 1 - pivot;
+    }
+    else
+    {
+      introsort_loop(SORT_ELEMENT(base, pivot + 1, size), count - 1 - pivot, size, compare, depth);
+      count = pivot;
+    }
+  }
+
+  insertion_sort(base, count, size, compare);
+}
+
+static void select_loop(unsigned char * base, size_t count, size_t size,
+                        int (*compare)(const void *, const void *), size_t depth,
+                        size_t first, const size_t * ranks, size_t rank_count)
+{
+  size_t pivot;
+  size_t lower;
+  size_t upper;
+
+  while(count > SORT_INSERTION_CUTOFF && rank_count > 0)
+  {
+    if(depth == 0)
+    {
+      heap_sort(base, count, size, compare);
+      return;
+    }
+    --depth;
+
+    /* Ranks before the pivot go left, ranks after it go right, a rank on the pivot is done */
+    pivot = partition(base, count, size, compare);
+    lower = 0;
+    while(lower < rank_count && *(ranks+lower) < first + pivot)
+    {
+      ++lower;
+    }
+    upper = lower;
+    while(upper < rank_count && *(ranks+upper) == first + pivot)
+    {
+      ++upper;
+    }
+
+    select_loop(base, pivot, size, compare, depth, first, ranks, lower);
+    base = SORT_ELEMENT(base, pivot + 1, size);
+    count = count - 1 - pivot;
+    first += pivot + 1;
+    ranks += upper;
+    rank_count -= upper;
+  }
+
+  if(rank_count > 0)
+  {
+    insertion_sort(base, count, size, compare);
+  }
+}
+
+static size_t partition(unsigned char * base, size_t count, size_t size,
+                        int (*compare)(const void *, const void *))
+{
+  unsigned char * first;
+  unsigned char * middle;
+  unsigned char * last;
+  size_t i;
+  size_t j;
+
+  /* Order the first, middle and last elements and move the median to the front as the pivot */
+  first = base;
+  middle = SORT_ELEMENT(base, count / 2, size);
+  last = SORT_ELEMENT(base, count - 1, size);
+  if(compare(middle, first) < 0)
+  {
+    swap_elements(middle, first, size);
+  }
+  if(compare(last, middle) < 0)
+  {
+    swap_elements(last, middle, size);
+    if(compare(middle, first) < 0)
+    {
+      swap_elements(middle, first, size);
+    }
+  }
+  swap_elements(first, middle, size);
+
+  /* Hoare partition, both scans stop on elements equal to the pivot to balance duplicates */
+  i = 1;
+  j = count - 1;
+  for(;;)
+  {
+    while(i <= j && compare(SORT_ELEMENT(base, i, size), base) < 0)
+    {
+      ++i;
+    }
+    while(i <= j && compare(SORT_ELEMENT(base, j, size), base) > 0)
+    {
+      --j;
+    }
+    if(i >= j)
+    {
+      break;
+    }
+    swap_elements(SORT_ELEMENT(base, i, size), SORT_ELEMENT(base, j, size), size);
+    ++i;
+    --j;
+  }
+  swap_elements(base, SORT_ELEMENT(base, j, size), size);
+
+  /* Elements [0, j) are not greater than the pivot at j, elements (j, count) are not smaller */
+  return j;
+}
+
+static void insertion_sort(unsigned char * base, size_t count, size_t size,
+                           int (*compare)(const void *, const void *))
+{
+  size_t i;
+  size_t j;
+
+  for(i = 1; i < count; ++i)
+  {
+    for(j = i; j > 0 && compare(SORT_ELEMENT(base, j - 1, size), SORT_ELEMENT(base, j, size)) > 0; --j)
+    {
+      swap_elements(SORT_ELEMENT(base, j - 1, size), SORT_ELEMENT(base, j, size), size);
+    }
+  }
+}
+
+static void heap_sort(unsigned char * base, size_t count, size_t size,
+                      int (*compare)(const void *, const void *))
+{
+  size_t i;
+
+  for(i = count / 2; i > 0; --i)
+  {
+    sift_down(base, i - 1, count, size, compare);
+  }
+  for(i = count - 1; i > 0; --i)
+  {
+    swap_elements(base, SORT_ELEMENT(base, i, size), size);
+    sift_down(base, 0, i, size, compare);
+  }
+}
+
+static void sift_down(unsigned char * base, size_t root, size_t count, size_t size,
+                      int (*compare)(const void *, const void *))
+{
+  size_t child;
+
+  while((child = 2 * root + 1) < count)
+  {
+    if(child + 1 < count && compare(SORT_ELEMENT(base, child, size), SORT_ELEMENT(base, child + 1, size)) < 0)
+    {
+      ++child;
+    }
+    if(compare(SORT_ELEMENT(base, root, size), SORT_ELEMENT(base, child, size)) >= 0)
+    {
+      return;
+    }
+    swap_elements(SORT_ELEMENT(base, root, size), SORT_ELEMENT(base, child, size), size);
+    root = child;
+  }
+}
+
+static void swap_elements(unsigned char * a, unsigned char * b, size_t size)
+{
+  unsigned char temp;
+  size_t i;
+
+  for(i = 0; i < size; ++i)
+  {
+    temp = *(a+i);
+    *(a+i) = *(b+i);
+    *(b+i) = temp;
+  }
+}
@@ -37,6 +37,9 @@
 #include <stdint.h>
 
 /* Forward declaration of the default fault handlers. */
+/* Top of the stack, from the linker script */
+extern uint32_t __StackTop;
+
 extern void Reset_Handler(void);
 extern void NMI_Handler(void);
 extern void HardFault_Handler(void);
@@ -96,7 +99,7 @@ extern void PORT6_IRQHandler(void);
 /* the program if located at a start address other than 0.                            */
 void (* const interruptVectors[])(void) __attribute__ ((section (".intvecs"))) =
 {
-    (void (*)(void))((uint32_t)0x20004000),
+    (void (*)(void))((uint32_t)&__StackTop),
                                             /* The initial stack pointer */
     &Reset_Handler,                         /* The reset handler         */
     &NMI_Handler,                           /* The NMI handler           */
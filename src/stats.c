@@ -13,8 +13,9 @@
  * @brief File containing the defintion of statistics functions for an unsigned char array. 
  *
  * Contains the implementation of several statistics functions for unsigned char arrays, 
- * including the median, mean, maximum, and minimum. Additionally, there is a utility function 
- * provided to sort the array in descending order.
+ * including the median, k-th order statistic, mean, maximum, and minimum, and a single pass summary
+ * that computes all of them from one histogram. Additionally, there is a utility function provided to
+ * sort the array in descending order.
  *
  * @author Julian Hoyos
  * @date 27/03/2023
@@ -25,133 +26,382 @@
 #include <string.h>
 #include "platform.h"
 #include "stats.h"
+#include "selection.h"
+#include "parallel.h"
+#include "summary.h"
+#include "sort.h"
 
-/* Size of the Data Set */
-#define SIZE (40)
+static unsigned char median_inplace(unsigned char * work, size_t array_size);
+static size_t extreme_k(const unsigned char * array_pointer, size_t array_size, size_t k, unsigned char * out,
+                        unsigned char * work, size_t * histogram, uint8_t largest);
+static unsigned char * extreme_k_work(unsigned char * array_pointer, size_t array_size,
+                                      stats_scratch_t * scratch, stats_input_t input);
+static size_t * extreme_k_histogram(size_t array_size, stats_scratch_t * scratch);
+static int compare_ascending(const void * a, const void * b);
+static int compare_descending(const void * a, const void * b);
 
 /* Function definition*/
-void print_statistics(unsigned char* array_pointer, unsigned int array_size)
+void print_statistics(unsigned char* array_pointer, size_t array_size)
 {
-  unsigned char median;
-  unsigned char mean;
-  unsigned char maximum;
-  unsigned char minimum;
+  stats_summary_t summary;
 
-  median = find_median(array_pointer, array_size);
-  mean = find_mean(array_pointer, array_size);
-  maximum = find_maximum(array_pointer, array_size);
-  minimum = find_minimum(array_pointer, array_size);
+  summary = compute_summary(array_pointer, array_size);
+  print_summary(&summary);
 
-  printf("Median: %d  - Mean: %d  - Maximum: %d - Minimum: %d \n", median, mean, maximum, minimum);
+}
+
+void print_summary(const stats_summary_t * summary)
+{
+  printf("Median: %d  - Mean: %d  - Maximum: %d - Minimum: %d \n", summary->median, summary->mean, summary->maximum, summary->minimum);
+  printf("Mode: %d  - Range: %d  - Variance: %.3f - Std dev: %.3f - Skewness: %.3f - Kurtosis: %.3f \n",
+         summary->mode, summary->range, summary->variance, summary->stddev, summary->skewness, summary->kurtosis);
+}
 
+stats_summary_t compute_summary(const unsigned char* array_pointer, size_t array_size)
+{
+  stats_summary_t summary;
+
+  /* The only pass over the data, everything else is read from the histogram */
+  select_histogram(array_pointer, array_size, summary.histogram);
+  summary_from_histogram(&summary);
+
+  return summary;
 }
 
-void print_array(unsigned char* array_pointer, unsigned int array_size)
+void print_array(unsigned char* array_pointer, size_t array_size)
 {
 #ifdef VERBOSE
-  unsigned char i;
+  size_t i;
   for(i = 0; i < array_size ; ++i)
   {
-    PRINTF("%dth element: %d\n", i, *(array_pointer+i));
+    PRINTF("%zuth element: %d\n", i, *(array_pointer+i));
   }
 #endif
 }
 
-unsigned char find_median(unsigned char* array_pointer, unsigned int array_size)
+unsigned char find_median(unsigned char* array_pointer, size_t array_size)
+{
+  unsigned char scratch[SELECT_SMALL_SIZE];
+  size_t histogram[SELECT_BUCKETS];
+
+  if(0 == array_size)
+  {
+    return 0;
+  }
+
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    /* Short arrays: select in place on a copy */
+    memcpy(scratch, array_pointer, array_size * sizeof(unsigned char));
+    return median_inplace(scratch, array_size);
+  }
+
+  /* Long arrays: one counting pass answers both middle ranks */
+  select_histogram(array_pointer, array_size, histogram);
+  return select_median_histogram(histogram, array_size);
+}
+
+unsigned char find_median_scratch(unsigned char* array_pointer, size_t array_size,
+                                  stats_scratch_t* scratch, stats_input_t input)
 {
-  unsigned char median;
-  unsigned char mid_element;
-  unsigned char sorted_array[array_size];
-  unsigned char* sorted_array_pointer = sorted_array;
+  size_t mark = scratch_mark(scratch);
+  unsigned char * copy;
+  size_t * histogram;
+  unsigned char median = 0;
 
-  /* Copy array */
-  memcpy(sorted_array_pointer, array_pointer, array_size * sizeof(unsigned char));
-  sort_array(sorted_array_pointer, array_size);
-  mid_element = array_size/2;
- 
-  if(0 != array_size % 2 )
+  if(0 == array_size)
+  {
+    return 0;
+  }
+  if(input == STATS_MAY_REORDER)
   {
-    median = *(sorted_array_pointer+mid_element);
+    return median_inplace(array_pointer, array_size);
+  }
+
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    copy = (unsigned char *)scratch_alloc(scratch, array_size * sizeof(unsigned char));
+    if(copy != NULL)
+    {
+      memcpy(copy, array_pointer, array_size * sizeof(unsigned char));
+      median = median_inplace(copy, array_size);
+    }
   }
   else
   {
-    median = (*(sorted_array_pointer+mid_element) + *(sorted_array_pointer+mid_element-1))/2;
+    histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+    if(histogram != NULL)
+    {
+      select_histogram(array_pointer, array_size, histogram);
+      median = select_median_histogram(histogram, array_size);
+    }
   }
 
+  scratch_release(scratch, mark);
   return median;
 }
 
-unsigned char find_mean(unsigned char* array_pointer, unsigned int array_size)
+unsigned char find_kth(unsigned char* array_pointer, size_t array_size, size_t k)
 {
-  unsigned int sum_value = 0;
-  unsigned char mean = 0;
-  unsigned char i;
+  unsigned char scratch[SELECT_SMALL_SIZE];
 
-  for(i = 0; i < array_size ; ++i)
+  if(k >= array_size)
   {
-    sum_value += *(array_pointer+i);
+    return 0;
   }
 
-  mean = (unsigned char)(sum_value/array_size);
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    memcpy(scratch, array_pointer, array_size * sizeof(unsigned char));
+    return select_kth_inplace(scratch, array_size, k);
+  }
 
-  return mean;
+  return select_kth_counting(array_pointer, array_size, k);
 }
 
-unsigned char find_maximum(unsigned char* array_pointer, unsigned int array_size)
+unsigned char find_kth_scratch(unsigned char* array_pointer, size_t array_size, size_t k,
+                               stats_scratch_t* scratch, stats_input_t input)
 {
-  unsigned char maximum = 0;
-  unsigned char i;
+  size_t mark = scratch_mark(scratch);
+  unsigned char * copy;
+  size_t * histogram;
+  unsigned char kth = 0;
 
-  for(i = 0; i < array_size ; ++i)
+  if(k >= array_size)
   {
-    maximum = maximum < *(array_pointer+i) ? *(array_pointer+i) : maximum;
+    return 0;
+  }
+  if(input == STATS_MAY_REORDER)
+  {
+    return select_kth_inplace(array_pointer, array_size, k);
   }
 
-  return maximum;
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    copy = (unsigned char *)scratch_alloc(scratch, array_size * sizeof(unsigned char));
+    if(copy != NULL)
+    {
+      memcpy(copy, array_pointer, array_size * sizeof(unsigned char));
+      kth = select_kth_inplace(copy, array_size, k);
+    }
+  }
+  else
+  {
+    histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+    if(histogram != NULL)
+    {
+      select_histogram(array_pointer, array_size, histogram);
+      kth = select_kth_histogram(histogram, k);
+    }
+  }
+
+  scratch_release(scratch, mark);
+  return kth;
 }
 
-unsigned char find_minimum(unsigned char* array_pointer, unsigned int array_size)
+size_t find_top_k(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out)
 {
-  unsigned char minimum = 255;
-  unsigned char i;
+  unsigned char copy[SELECT_SMALL_SIZE];
+  size_t histogram[SELECT_BUCKETS];
 
-  for(i = 0; i < array_size ; ++i)
+  return extreme_k(array_pointer, array_size, k, out, copy, histogram, 1);
+}
+
+size_t find_top_k_scratch(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out,
+                          stats_scratch_t* scratch, stats_input_t input)
+{
+  size_t mark = scratch_mark(scratch);
+  size_t written;
+
+  written = extreme_k(array_pointer, array_size, k, out,
+                      extreme_k_work(array_pointer, array_size, scratch, input),
+                      extreme_k_histogram(array_size, scratch), 1);
+
+  scratch_release(scratch, mark);
+  return written;
+}
+
+size_t find_bottom_k(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out)
+{
+  unsigned char copy[SELECT_SMALL_SIZE];
+  size_t histogram[SELECT_BUCKETS];
+
+  return extreme_k(array_pointer, array_size, k, out, copy, histogram, 0);
+}
+
+size_t find_bottom_k_scratch(unsigned char* array_pointer, size_t array_size, size_t k, unsigned char* out,
+                             stats_scratch_t* scratch, stats_input_t input)
+{
+  size_t mark = scratch_mark(scratch);
+  size_t written;
+
+  written = extreme_k(array_pointer, array_size, k, out,
+                      extreme_k_work(array_pointer, array_size, scratch, input),
+                      extreme_k_histogram(array_size, scratch), 0);
+
+  scratch_release(scratch, mark);
+  return written;
+}
+
+unsigned char find_mean(unsigned char* array_pointer, size_t array_size)
+{
+  parallel_result_t result;
+
+  if(0 == array_size)
   {
-    minimum = minimum > *(array_pointer+i) ? *(array_pointer+i) : minimum;
+    return 0;
   }
 
-  return minimum;
+  parallel_reduce(array_pointer, array_size, PARALLEL_OP_SUM, &result, NULL);
+
+  return (unsigned char)(result.sum/array_size);
 }
 
-void sort_array(unsigned char* array_pointer, unsigned int array_size)
+unsigned char find_maximum(unsigned char* array_pointer, size_t array_size)
 {
-  unsigned char i;
-  unsigned char j;
-  unsigned char current_value;
-  unsigned char max_value;
-  unsigned char max_index;
-  
+  parallel_result_t result;
 
-  for(i = 0; i < array_size ; ++i)
+  parallel_reduce(array_pointer, array_size, PARALLEL_OP_MAXIMUM, &result, NULL);
+
+  return result.maximum;
+}
+
+unsigned char find_minimum(unsigned char* array_pointer, size_t array_size)
+{
+  parallel_result_t result;
+
+  parallel_reduce(array_pointer, array_size, PARALLEL_OP_MINIMUM, &result, NULL);
+
+  return result.minimum;
+}
+
+void sort_array(unsigned char* array_pointer, size_t array_size)
+{
+  sort_counting_u8(array_pointer, array_size, SORT_DESCENDING);
+}
+
+void sort_array_parallel(unsigned char* array_pointer, size_t array_size)
+{
+  sort_counting_u8_parallel(array_pointer, array_size, SORT_DESCENDING);
+}
+
+static size_t extreme_k(const unsigned char * array_pointer, size_t array_size, size_t k, unsigned char * out,
+                        unsigned char * work, size_t * histogram, uint8_t largest)
+{
+  size_t written = 0;
+  size_t remaining;
+  size_t run;
+  size_t value;
+  size_t i;
+
+  k = k < array_size ? k : array_size;
+  if(0 == k)
   {
-    current_value = *(array_pointer+i);
-    max_value = current_value;
+    return 0;
+  }
 
-    for(j = i; j < array_size ; ++j)
+  /* Short arrays: partial sort of a copy, or of the array itself when it may be reordered */
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    if(work == NULL)
     {
-      if( max_value < *(array_pointer+j))
-      {
-        max_value = *(array_pointer+j);
-        max_index = j;
-      }
+      return 0;
     }
+    if(work != array_pointer)
+    {
+      memcpy(work, array_pointer, array_size * sizeof(unsigned char));
+    }
+    sort_partial(work, array_size, sizeof(unsigned char), largest ? compare_descending : compare_ascending, k);
+    for(i = 0; i < k; ++i)
+    {
+      *(out+i) = largest ? *(work+i) : *(work+k-1-i);
+    }
+    return k;
+  }
 
-    if(max_value != current_value)
+  if(histogram == NULL)
+  {
+    return 0;
+  }
+  select_histogram(array_pointer, array_size, histogram);
+  if(largest)
+  {
+    value = SELECT_BUCKETS;
+    while(written < k)
     {
-      *(array_pointer+i) = max_value;
-      *(array_pointer+max_index) = current_value;
+      --value;
+      run = histogram[value] < k - written ? histogram[value] : k - written;
+      memset(out + written, (int)value, run);
+      written += run;
     }
+    return k;
   }
 
+  /* Walk up from 0 and fill the output from its end, so the largest value comes first */
+  remaining = k;
+  value = 0;
+  while(remaining > 0)
+  {
+    run = histogram[value] < remaining ? histogram[value] : remaining;
+    remaining -= run;
+    memset(out + remaining, (int)value, run);
+    ++value;
+  }
+  return k;
 }
 
+static unsigned char * extreme_k_work(unsigned char * array_pointer, size_t array_size,
+                                      stats_scratch_t * scratch, stats_input_t input)
+{
+  if(array_size > SELECT_SMALL_SIZE)
+  {
+    return NULL;
+  }
+  if(input == STATS_MAY_REORDER)
+  {
+    return array_pointer;
+  }
+  return (unsigned char *)scratch_alloc(scratch, array_size * sizeof(unsigned char));
+}
+
+static size_t * extreme_k_histogram(size_t array_size, stats_scratch_t * scratch)
+{
+  if(array_size <= SELECT_SMALL_SIZE)
+  {
+    return NULL;
+  }
+  return (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+}
+
+static int compare_ascending(const void * a, const void * b)
+{
+  return (int)*(const unsigned char *)a - (int)*(const unsigned char *)b;
+}
+
+static int compare_descending(const void * a, const void * b)
+{
+  return (int)*(const unsigned char *)b - (int)*(const unsigned char *)a;
+}
+
+static unsigned char median_inplace(unsigned char * work, size_t array_size)
+{
+  unsigned char upper;
+  unsigned char lower;
+  size_t mid_element = array_size/2;
+  size_t i;
+
+  /* After the selection the lower half holds the other middle element */
+  upper = select_kth_inplace(work, array_size, mid_element);
+  if(0 != array_size % 2)
+  {
+    return upper;
+  }
+
+  lower = *work;
+  for(i = 1; i < mid_element; ++i)
+  {
+    lower = lower < *(work+i) ? *(work+i) : lower;
+  }
+
+  return (unsigned char)((lower + upper)/2);
+}
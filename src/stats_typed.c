@@ -0,0 +1,487 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file stats_typed.c
+ * @brief File containing the definition of the typed statistics kernels.
+ *
+ * The template below is expanded once per sample type. The array is processed in blocks of
+ * STATS_MOMENTS_BLOCK samples with two branch-free loops per block: the first one computes the
+ * minimum, maximum and exact sum and vectorizes for the integer types, the second one computes
+ * the power sums of the block around its first sample and vectorizes when floating point
+ * reassociation is allowed. Every block is then merged into the running moments (see moments.h),
+ * so the memory is traversed once and the higher moments stay accurate on long arrays. 8-bit samples
+ * are also counted block by block in a histogram whose fullest bin is the mode. The mode of the
+ * other types, the longest run of a sorted copy, is only computed by the stats_mode_* functions.
+ *
+ * The percentile template computes every requested rank, sorts the ranks and hands them to one
+ * sort_select call, which only partitions the parts of the copy that hold a requested rank. The
+ * allocating find_percentiles_* run their arena variant over one block from reserve_words.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "stats_typed.h"
+#include "moments.h"
+#include "selection.h"
+#include "sort.h"
+#include "memory.h"
+
+/* Samples per block of the moments kernel, small enough for the block to stay in the L1 cache */
+#define STATS_MOMENTS_BLOCK (256)
+
+static size_t percentiles_counting(const uint8_t * array_pointer, size_t array_size,
+                                   const double * qs, size_t nq, uint8_t * out, size_t * histogram);
+static uint8_t histogram_mode(const size_t * histogram);
+static void sort_copy_u16(uint16_t * values, size_t array_size, uint16_t * scratch);
+static void sort_copy_i32(int32_t * values, size_t array_size, int32_t * scratch);
+static void sort_copy_f32(float * values, size_t array_size, float * scratch);
+static void sort_copy_f64(double * values, size_t array_size, double * scratch);
+static void percentile_ranks(const double * qs, size_t nq, size_t array_size, size_t * ranks, size_t * sorted);
+
+/* Defines stats_pass_<suffix>, the blocked pass behind stats_<suffix>, which also counts a
+   histogram when one is given */
+#define STATS_PASS_DEFINE(suffix, type, sum_type)                                               \
+static void stats_pass_##suffix(const type * array_pointer, size_t array_size,                  \
+                               stats_##suffix##_t * result, size_t * histogram)                 \
+{                                                                                               \
+  stats_moments_t moments;                                                                      \
+  type minimum;                                                                                 \
+  type maximum;                                                                                 \
+  type value;                                                                                   \
+  sum_type sum = 0;                                                                             \
+  double shift;                                                                                 \
+  double d;                                                                                     \
+  double d2;                                                                                    \
+  double s1;                                                                                    \
+  double s2;                                                                                    \
+  double s3;                                                                                    \
+  double s4;                                                                                    \
+  size_t start;                                                                                 \
+  size_t end;                                                                                   \
+  size_t i;                                                                                     \
+                                                                                                \
+  result->count = array_size;                                                                   \
+  result->minimum = 0;                                                                          \
+  result->maximum = 0;                                                                          \
+  result->sum = 0;                                                                              \
+  result->range = 0.0;                                                                          \
+  result->mean = 0.0;                                                                           \
+  result->variance = 0.0;                                                                       \
+  result->stddev = 0.0;                                                                         \
+  result->skewness = 0.0;                                                                       \
+  result->kurtosis = 0.0;                                                                       \
+  if(array_pointer == NULL || 0 == array_size)                                                  \
+  {                                                                                             \
+    result->count = 0;                                                                          \
+    return;                                                                                     \
+  }                                                                                             \
+                                                                                                \
+  minimum = *array_pointer;                                                                     \
+  maximum = *array_pointer;                                                                     \
+  moments_init(&moments);                                                                       \
+  for(start = 0; start < array_size; start = end)                                               \
+  {                                                                                             \
+    end = array_size - start > STATS_MOMENTS_BLOCK ? start + STATS_MOMENTS_BLOCK : array_size;  \
+                                                                                                \
+    for(i = start; i < end; ++i)                                                                \
+    {                                                                                           \
+      value = *(array_pointer+i);                                                               \
+      minimum = value < minimum ? value : minimum;                                              \
+      maximum = value > maximum ? value : maximum;                                              \
+      sum += (sum_type)value;                                                                   \
+    }                                                                                           \
+                                                                                                \
+    /* Power sums of the block around its first sample, read again from the cache */            \
+    shift = (double)*(array_pointer+start);                                                     \
+    s1 = 0.0;                                                                                   \
+    s2 = 0.0;                                                                                   \
+    s3 = 0.0;                                                                                   \
+    s4 = 0.0;                                                                                   \
+    for(i = start; i < end; ++i)                                                                \
+    {                                                                                           \
+      d = (double)*(array_pointer+i) - shift;                                                   \
+      d2 = d * d;                                                                               \
+      s1 += d;                                                                                  \
+      s2 += d2;                                                                                 \
+      s3 += d2 * d;                                                                             \
+      s4 += d2 * d2;                                                                            \
+    }                                                                                           \
+    moments_add_block(&moments, end - start, shift, s1, s2, s3, s4);                            \
+                                                                                                \
+    /* Only 8-bit samples are counted, still from the cache */                                  \
+    if(histogram != NULL)                                                                       \
+    {                                                                                           \
+      for(i = start; i < end; ++i)                                                              \
+      {                                                                                         \
+        ++*(histogram + (size_t)*(array_pointer+i));                                            \
+      }                                                                                         \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  result->minimum = minimum;                                                                    \
+  result->maximum = maximum;                                                                    \
+  result->sum = sum;                                                                            \
+  result->range = (double)maximum - (double)minimum;                                            \
+  result->mean = moments.mean;                                                                  \
+  result->variance = moments_variance(&moments);                                                \
+  result->stddev = sqrt(result->variance);                                                      \
+  result->skewness = moments_skewness(&moments);                                                \
+  result->kurtosis = moments_kurtosis(&moments);                                                \
+}
+
+/* Defines the kernel stats_<suffix> of a sample type wider than 8 bits */
+#define STATS_TYPED_DEFINE(suffix, type)                                                        \
+stats_##suffix##_t stats_##suffix(const type * array_pointer, size_t array_size)                \
+{                                                                                               \
+  stats_##suffix##_t result;                                                                    \
+                                                                                                \
+  stats_pass_##suffix(array_pointer, array_size, &result, NULL);                                \
+  return result;                                                                                \
+}
+
+/* Defines stats_mode_<suffix> and its arena variant, the longest run of a copy sorted by
+   sort_copy_<suffix> with radix_count samples of scratch */
+#define STATS_MODE_DEFINE(suffix, type, radix_count)                                            \
+uint8_t stats_mode_##suffix(const type * array_pointer, size_t array_size, type * mode)         \
+{                                                                                               \
+  stats_scratch_t scratch;                                                                      \
+  int32_t * buffer = NULL;                                                                      \
+  size_t bytes = SCRATCH_MODE_BYTES(array_size, sizeof(type));                                  \
+  uint8_t found;                                                                                \
+                                                                                                \
+  if(array_pointer != NULL && array_size != 0)                                                  \
+  {                                                                                             \
+    buffer = reserve_words((bytes + sizeof(int32_t) - 1) / sizeof(int32_t));                    \
+  }                                                                                             \
+  scratch_init(&scratch, buffer, bytes);                                                        \
+                                                                                                \
+  /* The array is only read, it is copied to the arena before sorting */                        \
+  found = stats_mode_##suffix##_scratch((type *)array_pointer, array_size, mode, &scratch,      \
+                                        STATS_KEEP_INPUT);                                      \
+                                                                                                \
+  free_words(buffer);                                                                           \
+  return found;                                                                                 \
+}                                                                                               \
+                                                                                                \
+uint8_t stats_mode_##suffix##_scratch(type * array_pointer, size_t array_size, type * mode,     \
+                                      stats_scratch_t * scratch, stats_input_t input)           \
+{                                                                                               \
+  size_t mark = scratch_mark(scratch);                                                          \
+  type * values = array_pointer;                                                                \
+  type * radix = NULL;                                                                          \
+  size_t best = 0;                                                                              \
+  size_t run = 0;                                                                               \
+  size_t i;                                                                                     \
+                                                                                                \
+  if(array_pointer == NULL || 0 == array_size)                                                  \
+  {                                                                                             \
+    return 0;                                                                                   \
+  }                                                                                             \
+  if(input != STATS_MAY_REORDER)                                                                \
+  {                                                                                             \
+    values = (type *)scratch_alloc(scratch, array_size * sizeof(type));                         \
+  }                                                                                             \
+  if(radix_count > 0)                                                                           \
+  {                                                                                             \
+    radix = (type *)scratch_alloc(scratch, (radix_count) * sizeof(type));                       \
+  }                                                                                             \
+  if(values == NULL || (radix_count > 0 && radix == NULL))                                      \
+  {                                                                                             \
+    scratch_release(scratch, mark);                                                             \
+    return 0;                                                                                   \
+  }                                                                                             \
+                                                                                                \
+  if(values != array_pointer)                                                                   \
+  {                                                                                             \
+    memcpy(values, array_pointer, array_size * sizeof(type));                                   \
+  }                                                                                             \
+  sort_copy_##suffix(values, array_size, radix);                                                \
+                                                                                                \
+  /* Ascending order, a later run must be strictly longer so ties keep the smallest value */    \
+  *mode = *values;                                                                              \
+  for(i = 0; i < array_size; ++i)                                                               \
+  {                                                                                             \
+    run = (i > 0 && *(values+i) == *(values+i-1)) ? run + 1 : 1;                                \
+    if(run > best)                                                                              \
+    {                                                                                           \
+      best = run;                                                                               \
+      *mode = *(values+i);                                                                      \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  scratch_release(scratch, mark);                                                               \
+  return 1;                                                                                     \
+}
+
+/* Defines find_percentiles_<suffix> and its arena variant, a multiselect over a copy of the array */
+#define STATS_PERCENTILES_DEFINE(suffix, type)                                                  \
+static int compare_##suffix(const void * a, const void * b)                                     \
+{                                                                                               \
+  type x = *(const type *)a;                                                                    \
+  type y = *(const type *)b;                                                                    \
+                                                                                                \
+  return (x > y) - (x < y);                                                                     \
+}                                                                                               \
+                                                                                                \
+size_t find_percentiles_##suffix(const type * array_pointer, size_t array_size,                 \
+                                 const double * qs, size_t nq, type * out)                      \
+{                                                                                               \
+  stats_scratch_t scratch;                                                                      \
+  int32_t * buffer = NULL;                                                                      \
+  size_t bytes;                                                                                 \
+  size_t found;                                                                                 \
+                                                                                                \
+  bytes = SCRATCH_PERCENTILES_BYTES(array_size, sizeof(type), nq);                              \
+  if(array_pointer != NULL && array_size != 0 && nq != 0)                                       \
+  {                                                                                             \
+    buffer = reserve_words((bytes + sizeof(int32_t) - 1) / sizeof(int32_t));                    \
+  }                                                                                             \
+  scratch_init(&scratch, buffer, bytes);                                                        \
+                                                                                                \
+  /* The array is only read, it is copied to the arena before the selection */                  \
+  found = find_percentiles_##suffix##_scratch((type *)array_pointer, array_size, qs, nq, out,   \
+                                              &scratch, STATS_KEEP_INPUT);                      \
+                                                                                                \
+  free_words(buffer);                                                                           \
+  return found;                                                                                 \
+}                                                                                               \
+                                                                                                \
+size_t find_percentiles_##suffix##_scratch(type * array_pointer, size_t array_size,             \
+                                           const double * qs, size_t nq, type * out,            \
+                                           stats_scratch_t * scratch, stats_input_t input)      \
+{                                                                                               \
+  size_t mark = scratch_mark(scratch);                                                          \
+  size_t * ranks = NULL;                                                                        \
+  size_t * sorted;                                                                              \
+  type * values = array_pointer;                                                                \
+  size_t i;                                                                                     \
+                                                                                                \
+  if(array_pointer != NULL && array_size != 0 && nq != 0)                                       \
+  {                                                                                             \
+    ranks = (size_t *)scratch_alloc(scratch, 2 * nq * sizeof(size_t));                          \
+    if(ranks != NULL && input != STATS_MAY_REORDER)                                             \
+    {                                                                                           \
+      values = (type *)scratch_alloc(scratch, array_size * sizeof(type));                       \
+      ranks = values != NULL ? ranks : NULL;                                                    \
+    }                                                                                           \
+  }                                                                                             \
+  if(ranks == NULL)                                                                             \
+  {                                                                                             \
+    scratch_release(scratch, mark);                                                             \
+    for(i = 0; i < nq; ++i)                                                                     \
+    {                                                                                           \
+      *(out+i) = 0;                                                                             \
+    }                                                                                           \
+    return 0;                                                                                   \
+  }                                                                                             \
+  sorted = ranks + nq;                                                                          \
+                                                                                                \
+  if(values != array_pointer)                                                                   \
+  {                                                                                             \
+    memcpy(values, array_pointer, array_size * sizeof(type));                                   \
+  }                                                                                             \
+  percentile_ranks(qs, nq, array_size, ranks, sorted);                                          \
+  sort_select(values, array_size, sizeof(type), compare_##suffix, sorted, nq);                  \
+  for(i = 0; i < nq; ++i)                                                                       \
+  {                                                                                             \
+    *(out+i) = *(values+*(ranks+i));                                                            \
+  }                                                                                             \
+                                                                                                \
+  scratch_release(scratch, mark);                                                               \
+  return nq;                                                                                    \
+}
+
+/* Function definition*/
+STATS_PASS_DEFINE(u8, uint8_t, uint64_t)
+STATS_PASS_DEFINE(u16, uint16_t, uint64_t)
+STATS_PASS_DEFINE(i32, int32_t, int64_t)
+STATS_PASS_DEFINE(f32, float, double)
+STATS_PASS_DEFINE(f64, double, double)
+
+STATS_TYPED_DEFINE(u16, uint16_t)
+STATS_TYPED_DEFINE(i32, int32_t)
+STATS_TYPED_DEFINE(f32, float)
+STATS_TYPED_DEFINE(f64, double)
+
+STATS_PERCENTILES_DEFINE(u16, uint16_t)
+STATS_PERCENTILES_DEFINE(i32, int32_t)
+STATS_PERCENTILES_DEFINE(f32, float)
+STATS_PERCENTILES_DEFINE(f64, double)
+
+/* The radix sorts need a scratch array as long as the array */
+STATS_MODE_DEFINE(u16, uint16_t, array_size)
+STATS_MODE_DEFINE(i32, int32_t, array_size)
+STATS_MODE_DEFINE(f32, float, 0)
+STATS_MODE_DEFINE(f64, double, 0)
+
+stats_u8_t stats_u8(const uint8_t * array_pointer, size_t array_size)
+{
+  stats_u8_t result;
+  size_t histogram[SELECT_BUCKETS];
+  size_t value;
+
+  for(value = 0; value < SELECT_BUCKETS; ++value)
+  {
+    histogram[value] = 0;
+  }
+  stats_pass_u8(array_pointer, array_size, &result, histogram);
+  result.mode = histogram_mode(histogram);
+
+  return result;
+}
+
+uint8_t stats_mode_u8(const uint8_t * array_pointer, size_t array_size, uint8_t * mode)
+{
+  size_t histogram[SELECT_BUCKETS];
+
+  if(array_pointer == NULL || 0 == array_size)
+  {
+    return 0;
+  }
+  select_histogram(array_pointer, array_size, histogram);
+  *mode = histogram_mode(histogram);
+
+  return 1;
+}
+
+uint8_t stats_mode_u8_scratch(uint8_t * array_pointer, size_t array_size, uint8_t * mode,
+                              stats_scratch_t * scratch, stats_input_t input)
+{
+  size_t mark = scratch_mark(scratch);
+  size_t * histogram;
+
+  /* Counting never reorders the array, so both inputs take the same path */
+  (void)input;
+  if(array_pointer == NULL || 0 == array_size)
+  {
+    return 0;
+  }
+  histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+  if(histogram == NULL)
+  {
+    return 0;
+  }
+  select_histogram(array_pointer, array_size, histogram);
+  *mode = histogram_mode(histogram);
+
+  scratch_release(scratch, mark);
+  return 1;
+}
+
+size_t find_percentiles_u8(const uint8_t * array_pointer, size_t array_size,
+                           const double * qs, size_t nq, uint8_t * out)
+{
+  size_t histogram[SELECT_BUCKETS];
+
+  return percentiles_counting(array_pointer, array_size, qs, nq, out, histogram);
+}
+
+size_t find_percentiles_u8_scratch(uint8_t * array_pointer, size_t array_size,
+                                   const double * qs, size_t nq, uint8_t * out,
+                                   stats_scratch_t * scratch, stats_input_t input)
+{
+  size_t mark = scratch_mark(scratch);
+  size_t * histogram;
+  size_t found;
+
+  /* Counting never reorders the array, so both inputs take the same path */
+  (void)input;
+  histogram = (size_t *)scratch_alloc(scratch, SELECT_BUCKETS * sizeof(size_t));
+  found = percentiles_counting(array_pointer, array_size, qs, nq, out, histogram);
+
+  scratch_release(scratch, mark);
+  return found;
+}
+
+static uint8_t histogram_mode(const size_t * histogram)
+{
+  size_t value;
+  uint8_t mode = 0;
+
+  /* Strictly fuller bins only, so ties keep the smallest value and an empty histogram gives 0 */
+  for(value = 1; value < SELECT_BUCKETS; ++value)
+  {
+    mode = *(histogram+value) > *(histogram+mode) ? (uint8_t)value : mode;
+  }
+
+  return mode;
+}
+
+static void sort_copy_u16(uint16_t * values, size_t array_size, uint16_t * scratch)
+{
+  sort_radix_u16(values, array_size, scratch, SORT_ASCENDING);
+}
+
+static void sort_copy_i32(int32_t * values, size_t array_size, int32_t * scratch)
+{
+  sort_radix_i32(values, array_size, scratch, SORT_ASCENDING);
+}
+
+static void sort_copy_f32(float * values, size_t array_size, float * scratch)
+{
+  (void)scratch;
+  sort_generic(values, array_size, sizeof(float), compare_f32);
+}
+
+static void sort_copy_f64(double * values, size_t array_size, double * scratch)
+{
+  (void)scratch;
+  sort_generic(values, array_size, sizeof(double), compare_f64);
+}
+
+static size_t percentiles_counting(const uint8_t * array_pointer, size_t array_size,
+                                   const double * qs, size_t nq, uint8_t * out, size_t * histogram)
+{
+  size_t i;
+
+  if(array_pointer == NULL || 0 == array_size || histogram == NULL)
+  {
+    for(i = 0; i < nq; ++i)
+    {
+      *(out+i) = 0;
+    }
+    return 0;
+  }
+
+  /* One counting pass answers every rank */
+  select_histogram(array_pointer, array_size, histogram);
+  for(i = 0; i < nq; ++i)
+  {
+    *(out+i) = select_kth_histogram(histogram, select_quantile_rank(*(qs+i), array_size));
+  }
+
+  return nq;
+}
+
+static void percentile_ranks(const double * qs, size_t nq, size_t array_size, size_t * ranks, size_t * sorted)
+{
+  size_t rank;
+  size_t i;
+  size_t j;
+
+  /* Insertion sort, there are only a few quantiles */
+  for(i = 0; i < nq; ++i)
+  {
+    rank = select_quantile_rank(*(qs+i), array_size);
+    *(ranks+i) = rank;
+    for(j = i; j > 0 && *(sorted+j-1) > rank; --j)
+    {
+      *(sorted+j) = *(sorted+j-1);
+    }
+    *(sorted+j) = rank;
+  }
+}
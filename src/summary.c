@@ -0,0 +1,205 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file summary.c
+ * @brief File containing the definition of the mergeable partial summary operations.
+ *
+ * Every derived field of a summary is a function of its histogram, so merging is the addition of
+ * two histograms followed by summary_from_histogram. Integers are serialized byte by byte, which
+ * keeps the layout independent of the endianness and alignment of the platform.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "summary.h"
+#include "selection.h"
+#include "moments.h"
+
+static void write_u64(uint8_t * buffer, uint64_t value);
+static uint64_t read_u64(const uint8_t * buffer);
+
+/* Function definition*/
+void summary_init(stats_summary_t * summary)
+{
+  size_t value;
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    summary->histogram[value] = 0;
+  }
+  summary_from_histogram(summary);
+}
+
+void summary_from_histogram(stats_summary_t * summary)
+{
+  size_t value;
+  stats_moments_t moments;
+
+  summary->count = 0;
+  summary->sum = 0;
+  summary->sum_squares = 0;
+  summary->minimum = 0;
+  summary->maximum = 0;
+  summary->mean = 0;
+  summary->median = 0;
+  summary->mode = 0;
+  summary->range = 0;
+  summary->variance = 0.0;
+  summary->stddev = 0.0;
+  summary->skewness = 0.0;
+  summary->kurtosis = 0.0;
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    summary->count += summary->histogram[value];
+    summary->sum += (uint64_t)value * summary->histogram[value];
+    summary->sum_squares += (uint64_t)(value * value) * summary->histogram[value];
+  }
+
+  if(0 == summary->count)
+  {
+    return;
+  }
+
+  value = 0;
+  while(0 == summary->histogram[value])
+  {
+    ++value;
+  }
+  summary->minimum = (unsigned char)value;
+
+  value = STATS_HISTOGRAM_BINS - 1;
+  while(0 == summary->histogram[value])
+  {
+    --value;
+  }
+  summary->maximum = (unsigned char)value;
+  summary->range = (unsigned char)(summary->maximum - summary->minimum);
+
+  /* Every bin is a block of identical samples, merged into the moments in order */
+  moments_init(&moments);
+  for(value = summary->minimum; value <= summary->maximum; ++value)
+  {
+    moments_add_block(&moments, summary->histogram[value], (double)value, 0.0, 0.0, 0.0, 0.0);
+    if(summary->histogram[value] > summary->histogram[summary->mode])
+    {
+      summary->mode = (unsigned char)value;
+    }
+  }
+  summary->variance = moments_variance(&moments);
+  summary->stddev = sqrt(summary->variance);
+  summary->skewness = moments_skewness(&moments);
+  summary->kurtosis = moments_kurtosis(&moments);
+
+  summary->mean = (unsigned char)(summary->sum / summary->count);
+
+  summary->median = select_median_histogram(summary->histogram, summary->count);
+}
+
+void summary_merge(stats_summary_t * dst, const stats_summary_t * src)
+{
+  size_t value;
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    dst->histogram[value] += src->histogram[value];
+  }
+  summary_from_histogram(dst);
+}
+
+size_t summary_serialize(const stats_summary_t * summary, uint8_t * buffer, size_t buffer_size)
+{
+  size_t value;
+
+  if(summary == NULL || buffer == NULL || buffer_size < SUMMARY_SERIALIZED_SIZE)
+  {
+    return 0;
+  }
+
+  *(buffer+0) = 'S';
+  *(buffer+1) = 'T';
+  *(buffer+2) = 'S';
+  *(buffer+3) = '1';
+  write_u64(buffer+4, summary->count);
+  write_u64(buffer+12, summary->sum);
+  write_u64(buffer+20, summary->sum_squares);
+  *(buffer+28) = summary->minimum;
+  *(buffer+29) = summary->maximum;
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    write_u64(buffer+30+8*value, summary->histogram[value]);
+  }
+
+  return SUMMARY_SERIALIZED_SIZE;
+}
+
+stats_summary_t * summary_deserialize(const uint8_t * buffer, size_t buffer_size, stats_summary_t * summary)
+{
+  size_t value;
+  uint64_t counter;
+
+  if(buffer == NULL || summary == NULL || buffer_size < SUMMARY_SERIALIZED_SIZE)
+  {
+    return NULL;
+  }
+  if(*(buffer+0) != 'S' || *(buffer+1) != 'T' || *(buffer+2) != 'S' || *(buffer+3) != '1')
+  {
+    return NULL;
+  }
+
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    counter = read_u64(buffer+30+8*value);
+    if(counter > (size_t)-1)
+    {
+      return NULL;
+    }
+    summary->histogram[value] = (size_t)counter;
+  }
+  summary_from_histogram(summary);
+
+  if(read_u64(buffer+4) != summary->count || read_u64(buffer+12) != summary->sum ||
+     read_u64(buffer+20) != summary->sum_squares ||
+     *(buffer+28) != summary->minimum || *(buffer+29) != summary->maximum)
+  {
+    return NULL;
+  }
+
+  return summary;
+}
+
+static void write_u64(uint8_t * buffer, uint64_t value)
+{
+  uint8_t i;
+
+  for(i = 0; i < 8; ++i)
+  {
+    *(buffer+i) = (uint8_t)(value >> (8 * i));
+  }
+}
+
+static uint64_t read_u64(const uint8_t * buffer)
+{
+  uint64_t value = 0;
+  uint8_t i;
+
+  for(i = 0; i < 8; ++i)
+  {
+    value |= (uint64_t)*(buffer+i) << (8 * i);
+  }
+
+  return value;
+}
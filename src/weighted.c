@@ -0,0 +1,258 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file weighted.c
+ * @brief File containing the definition of the weighted statistics of an array of unsigned char.
+ *
+ * The template below is expanded once per weight type and only differs in the loop that builds the
+ * histogram of weights, which is branch-free: a weight that is not positive adds 0. Integer counts
+ * are summed exactly in the doubles of the histogram up to 2^53. Everything else works on the 256
+ * bins, so its cost does not depend on the size of the array.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include "weighted.h"
+
+/* Number of histogram bins, one per unsigned char value */
+#define WEIGHTED_BINS (256)
+
+static stats_weighted_t weighted_from_histogram(const double * histogram, size_t count);
+static size_t weighted_percentiles(const double * histogram, const double * qs, size_t nq, uint8_t * out);
+static size_t weighted_quantile(const double * histogram, double total_weight, double q);
+
+/* Defines the functions declared by WEIGHTED_DECLARE */
+#define WEIGHTED_DEFINE(suffix, weight_type)                                                    \
+static size_t weighted_histogram_##suffix(const uint8_t * samples, const weight_type * weights,  \
+                                          size_t array_size, double * histogram)                \
+{                                                                                               \
+  size_t count = 0;                                                                             \
+  size_t i;                                                                                     \
+  double weight;                                                                                \
+                                                                                                \
+  for(i = 0; i < WEIGHTED_BINS; ++i)                                                            \
+  {                                                                                             \
+    *(histogram+i) = 0.0;                                                                       \
+  }                                                                                             \
+  if(samples == NULL || weights == NULL)                                                        \
+  {                                                                                             \
+    return 0;                                                                                   \
+  }                                                                                             \
+  for(i = 0; i < array_size; ++i)                                                               \
+  {                                                                                             \
+    weight = (double)*(weights+i);                                                              \
+    *(histogram+*(samples+i)) += weight > 0.0 ? weight : 0.0;                                   \
+    count += weight > 0.0;                                                                      \
+  }                                                                                             \
+                                                                                                \
+  return count;                                                                                 \
+}                                                                                               \
+                                                                                                \
+stats_weighted_t stats_weighted_##suffix(const uint8_t * samples, const weight_type * weights,   \
+                                         size_t array_size)                                     \
+{                                                                                               \
+  double histogram[WEIGHTED_BINS];                                                              \
+  size_t count;                                                                                 \
+                                                                                                \
+  count = weighted_histogram_##suffix(samples, weights, array_size, histogram);                 \
+                                                                                                \
+  return weighted_from_histogram(histogram, count);                                             \
+}                                                                                               \
+                                                                                                \
+size_t find_weighted_percentiles_##suffix(const uint8_t * samples, const weight_type * weights, \
+                                          size_t array_size, const double * qs, size_t nq,      \
+                                          uint8_t * out)                                        \
+{                                                                                               \
+  double histogram[WEIGHTED_BINS];                                                              \
+                                                                                                \
+  weighted_histogram_##suffix(samples, weights, array_size, histogram);                         \
+                                                                                                \
+  return weighted_percentiles(histogram, qs, nq, out);                                          \
+}                                                                                               \
+                                                                                                \
+stats_weighted_t stats_weighted_##suffix##_scratch(const uint8_t * samples,                     \
+                                                   const weight_type * weights,                 \
+                                                   size_t array_size, stats_scratch_t * scratch) \
+{                                                                                               \
+  stats_weighted_t result = {0, 0.0, 0, 0, 0, 0.0, 0.0, 0.0};                                   \
+  size_t mark = scratch_mark(scratch);                                                          \
+  double * histogram = (double *)scratch_alloc(scratch, WEIGHTED_BINS * sizeof(double));        \
+  size_t count;                                                                                 \
+                                                                                                \
+  if(histogram != NULL)                                                                         \
+  {                                                                                             \
+    count = weighted_histogram_##suffix(samples, weights, array_size, histogram);               \
+    result = weighted_from_histogram(histogram, count);                                         \
+  }                                                                                             \
+                                                                                                \
+  scratch_release(scratch, mark);                                                               \
+  return result;                                                                                \
+}                                                                                               \
+                                                                                                \
+size_t find_weighted_percentiles_##suffix##_scratch(const uint8_t * samples,                    \
+                                                    const weight_type * weights,                \
+                                                    size_t array_size, const double * qs,       \
+                                                    size_t nq, uint8_t * out,                   \
+                                                    stats_scratch_t * scratch)                  \
+{                                                                                               \
+  size_t mark = scratch_mark(scratch);                                                          \
+  double * histogram = (double *)scratch_alloc(scratch, WEIGHTED_BINS * sizeof(double));        \
+  size_t found = 0;                                                                             \
+  size_t i;                                                                                     \
+                                                                                                \
+  if(histogram != NULL)                                                                         \
+  {                                                                                             \
+    weighted_histogram_##suffix(samples, weights, array_size, histogram);                       \
+    found = weighted_percentiles(histogram, qs, nq, out);                                       \
+  }                                                                                             \
+  else                                                                                          \
+  {                                                                                             \
+    for(i = 0; i < nq; ++i)                                                                     \
+    {                                                                                           \
+      *(out+i) = 0;                                                                             \
+    }                                                                                           \
+  }                                                                                             \
+                                                                                                \
+  scratch_release(scratch, mark);                                                               \
+  return found;                                                                                 \
+}
+
+/* Function definition*/
+WEIGHTED_DEFINE(u32, uint32_t)
+WEIGHTED_DEFINE(f64, double)
+
+static stats_weighted_t weighted_from_histogram(const double * histogram, size_t count)
+{
+  stats_weighted_t result = {0, 0.0, 0, 0, 0, 0.0, 0.0, 0.0};
+  double sum = 0.0;
+  double half;
+  double cumulative = 0.0;
+  double d;
+  size_t value;
+  size_t upper;
+
+  for(value = 0; value < WEIGHTED_BINS; ++value)
+  {
+    result.total_weight += *(histogram+value);
+    sum += (double)value * *(histogram+value);
+  }
+  if(result.total_weight <= 0.0)
+  {
+    return result;
+  }
+
+  result.count = count;
+  result.mean = sum / result.total_weight;
+  value = 0;
+  while(*(histogram+value) <= 0.0)
+  {
+    ++value;
+  }
+  result.minimum = (unsigned char)value;
+  value = WEIGHTED_BINS - 1;
+  while(*(histogram+value) <= 0.0)
+  {
+    --value;
+  }
+  result.maximum = (unsigned char)value;
+
+  /* Second pass over the bins, around the mean */
+  for(value = 0; value < WEIGHTED_BINS; ++value)
+  {
+    d = (double)value - result.mean;
+    result.variance += d * d * *(histogram+value);
+  }
+  result.variance /= result.total_weight;
+  result.stddev = sqrt(result.variance);
+
+  /* The lower middle value holds half of the weight, the median is the mean of both middle values
+     when it holds exactly half, like find_median on an even number of samples */
+  half = result.total_weight / 2.0;
+  value = 0;
+  cumulative = *histogram;
+  while(cumulative < half)
+  {
+    ++value;
+    cumulative += *(histogram+value);
+  }
+  result.median = (unsigned char)value;
+  if(cumulative == half)
+  {
+    upper = value + 1;
+    while(*(histogram+upper) <= 0.0)
+    {
+      ++upper;
+    }
+    result.median = (unsigned char)((value + upper) / 2);
+  }
+
+  return result;
+}
+
+static size_t weighted_percentiles(const double * histogram, const double * qs, size_t nq, uint8_t * out)
+{
+  double total_weight = 0.0;
+  size_t value;
+  size_t i;
+
+  for(value = 0; value < WEIGHTED_BINS; ++value)
+  {
+    total_weight += *(histogram+value);
+  }
+  if(total_weight <= 0.0)
+  {
+    for(i = 0; i < nq; ++i)
+    {
+      *(out+i) = 0;
+    }
+    return 0;
+  }
+
+  for(i = 0; i < nq; ++i)
+  {
+    *(out+i) = (uint8_t)weighted_quantile(histogram, total_weight, *(qs+i));
+  }
+
+  return nq;
+}
+
+static size_t weighted_quantile(const double * histogram, double total_weight, double q)
+{
+  double target;
+  double cumulative;
+  size_t value = 0;
+  size_t last;
+
+  q = q > 0.0 ? q : 0.0;
+  q = q < 1.0 ? q : 1.0;
+  target = q * total_weight;
+
+  /* The last bin with weight is the answer when rounding keeps the cumulative weight at the target */
+  last = WEIGHTED_BINS - 1;
+  while(*(histogram+last) <= 0.0)
+  {
+    --last;
+  }
+
+  cumulative = *histogram;
+  while(cumulative <= target && value < last)
+  {
+    ++value;
+    cumulative += *(histogram+value);
+  }
+
+  return value;
+}
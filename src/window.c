@@ -0,0 +1,221 @@
+/******************************************************************************
+ * Copyright (C) 2017 by Alex Fosdick - University of Colorado
+ *
+ * Redistribution, modification or use of this software in source or binary
+ * forms is permitted as long as the files maintain this copyright. Users are
+ * permitted to modify this and use it to learn about the field of embedded
+ * software. Alex Fosdick and the University of Colorado are not liable for any
+ * misuse of this material.
+ *
+ *****************************************************************************/
+/**
+ * @file window.c
+ * @brief File containing the definition of the sliding window statistics engine.
+ *
+ * Pushing a sample first drops the oldest sample once the window is full, then appends the new one.
+ * A deque drops its front when that front is the ring position being overwritten, and drops from
+ * its back every position the new sample makes useless, so every position enters and leaves each
+ * deque once. The median cursor is moved after every push until the lower middle rank falls in its
+ * bin again.
+ *
+ * @author Julian Hoyos
+ * @date 18/10/2026
+ *
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include "window.h"
+#include "selection.h"
+#include "memory.h"
+
+static void window_evict(stats_window_t * window);
+static void window_seek_median(stats_window_t * window);
+
+/* Function definition*/
+stats_window_t * window_create(size_t width)
+{
+  stats_window_t * window;
+  size_t bytes;
+
+  /* The size of the block, rounded up to words, must not wrap around */
+  if(0 == width ||
+     width > (SIZE_MAX - sizeof(stats_window_t) - sizeof(int32_t)) / (2 * sizeof(size_t) + 1))
+  {
+    return NULL;
+  }
+
+  /* Structure, both deques and the sample ring in one block of words */
+  bytes = sizeof(stats_window_t) + 2 * width * sizeof(size_t) + width;
+  window = (stats_window_t *)reserve_words((bytes + sizeof(int32_t) - 1) / sizeof(int32_t));
+  if(window == NULL)
+  {
+    return NULL;
+  }
+
+  window->width = width;
+  window->min_deque = (size_t *)(window + 1);
+  window->max_deque = window->min_deque + width;
+  window->samples = (unsigned char *)(window->max_deque + width);
+  window_reset(window);
+
+  return window;
+}
+
+void window_destroy(stats_window_t * window)
+{
+  free_words((int32_t *)window);
+}
+
+void window_reset(stats_window_t * window)
+{
+  size_t value;
+
+  window->count = 0;
+  window->head = 0;
+  window->sum = 0;
+  window->min_head = 0;
+  window->min_count = 0;
+  window->max_head = 0;
+  window->max_count = 0;
+  window->median = 0;
+  window->below = 0;
+  for(value = 0; value < STATS_HISTOGRAM_BINS; ++value)
+  {
+    window->histogram[value] = 0;
+  }
+}
+
+void window_push(stats_window_t * window, unsigned char sample)
+{
+  size_t position;
+  size_t back;
+
+  if(window->count == window->width)
+  {
+    window_evict(window);
+  }
+
+  position = window->head + window->count;
+  position = position >= window->width ? position - window->width : position;
+  *(window->samples+position) = sample;
+  ++window->count;
+  window->sum += sample;
+  ++window->histogram[sample];
+  if(sample < window->median)
+  {
+    ++window->below;
+  }
+
+  /* Positions whose sample is larger can never be the minimum again, and smaller ones the maximum */
+  while(window->min_count > 0)
+  {
+    back = window->min_head + window->min_count - 1;
+    back = back >= window->width ? back - window->width : back;
+    if(*(window->samples+*(window->min_deque+back)) <= sample)
+    {
+      break;
+    }
+    --window->min_count;
+  }
+  back = window->min_head + window->min_count;
+  *(window->min_deque+(back >= window->width ? back - window->width : back)) = position;
+  ++window->min_count;
+
+  while(window->max_count > 0)
+  {
+    back = window->max_head + window->max_count - 1;
+    back = back >= window->width ? back - window->width : back;
+    if(*(window->samples+*(window->max_deque+back)) >= sample)
+    {
+      break;
+    }
+    --window->max_count;
+  }
+  back = window->max_head + window->max_count;
+  *(window->max_deque+(back >= window->width ? back - window->width : back)) = position;
+  ++window->max_count;
+
+  window_seek_median(window);
+}
+
+size_t window_count(const stats_window_t * window)
+{
+  return window->count;
+}
+
+unsigned char window_minimum(const stats_window_t * window)
+{
+  if(0 == window->count)
+  {
+    return 0;
+  }
+  return *(window->samples+*(window->min_deque+window->min_head));
+}
+
+unsigned char window_maximum(const stats_window_t * window)
+{
+  if(0 == window->count)
+  {
+    return 0;
+  }
+  return *(window->samples+*(window->max_deque+window->max_head));
+}
+
+unsigned char window_mean(const stats_window_t * window)
+{
+  if(0 == window->count)
+  {
+    return 0;
+  }
+  return (unsigned char)(window->sum / window->count);
+}
+
+unsigned char window_median(const stats_window_t * window)
+{
+  /* The cursor already holds the lower middle rank, the walk starts there */
+  return select_median_from(window->histogram, window->count, window->median, window->below);
+}
+
+static void window_evict(stats_window_t * window)
+{
+  unsigned char sample = *(window->samples+window->head);
+
+  window->sum -= sample;
+  --window->histogram[sample];
+  if(sample < window->median)
+  {
+    --window->below;
+  }
+
+  if(window->min_count > 0 && *(window->min_deque+window->min_head) == window->head)
+  {
+    window->min_head = (window->min_head + 1 == window->width) ? 0 : window->min_head + 1;
+    --window->min_count;
+  }
+  if(window->max_count > 0 && *(window->max_deque+window->max_head) == window->head)
+  {
+    window->max_head = (window->max_head + 1 == window->width) ? 0 : window->max_head + 1;
+    --window->max_count;
+  }
+
+  window->head = (window->head + 1 == window->width) ? 0 : window->head + 1;
+  --window->count;
+}
+
+static void window_seek_median(stats_window_t * window)
+{
+  size_t rank = (window->count - 1) / 2;
+
+  /* The cursor value holds the lower middle rank when below <= rank < below + histogram[median] */
+  while(window->below > rank)
+  {
+    --window->median;
+    window->below -= window->histogram[window->median];
+  }
+  while(window->below + window->histogram[window->median] <= rank)
+  {
+    window->below += window->histogram[window->median];
+    ++window->median;
+  }
+}